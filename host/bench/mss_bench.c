@@ -0,0 +1,350 @@
+/******************************************************************************
+* MSS host microbenchmarks
+*
+* Runs the scheduler and the MSS modules on the host (POSIX) port and prints
+* the cost of the basic operations. The benchmarks call mss_scheduler()
+* directly instead of mss_run(), so the timer tick signal stays blocked and
+* does not disturb the measurement; timer ticks are generated by hand.
+*
+* usage: mss_bench [iterations]
+******************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "mss.h"
+#include "mss_int.h"
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+#define DEFAULT_ITERATIONS       (1000000UL)
+
+// number of running timers in the timer benchmarks
+#define NUM_OF_BENCH_TIMERS      (32)
+
+// task ids used by the benchmarks
+#define TASK_A                   (0)
+#define TASK_B                   (1)
+#define TASK_TIMER_OWNER         (MSS_NUM_OF_TASKS - 1)
+
+// iterations of the current benchmark
+static unsigned long iterations;
+
+// operation counter of the current benchmark
+static unsigned long ops;
+
+// rounds of the fan-out benchmark
+static unsigned long rounds;
+
+static mss_sema_t sema;
+static mss_mque_t mque;
+static mss_mque_msg_t msg;
+static mss_mem_t mem;
+static mss_timer_t timers[NUM_OF_BENCH_TIMERS];
+
+//*****************************************************************************
+// Helper functions
+//*****************************************************************************
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char* name, unsigned long n, uint64_t ns)
+{
+  printf("%-28s %10lu ops %10.1f ns/op %12.0f ops/s\n", name, n,
+         (double)ns / (double)n, (double)n * 1e9 / (double)ns);
+}
+
+static void run_scheduler(const char* name)
+{
+  uint64_t start;
+
+  ops = 0;
+  start = now_ns();
+  mss_scheduler();
+  report(name, ops, now_ns() - start);
+}
+
+static void idle_task(void* param)
+{
+  (void)param;
+}
+
+//*****************************************************************************
+// Benchmark tasks
+//*****************************************************************************
+
+// reactivates itself: one scheduler dispatch per run
+static void self_task(void* param)
+{
+  (void)param;
+
+  if(++ops < iterations)
+  {
+    mss_activate_task(mss_get_running_task_id());
+  }
+}
+
+// lowest priority task, activates all other task slots every run:
+// dispatches of many ready tasks
+static void fanout_root_task(void* param)
+{
+  uint8_t i;
+
+  (void)param;
+
+  ops++;
+  if(++rounds < (iterations / MSS_NUM_OF_TASKS))
+  {
+    for(i=0 ; i<MSS_NUM_OF_TASKS ; i++)
+    {
+      mss_activate_task(i);
+    }
+  }
+}
+
+static void fanout_leaf_task(void* param)
+{
+  (void)param;
+  ops++;
+}
+
+// event ping-pong between TASK_A and TASK_B
+static void event_task(void* param)
+{
+  static mss_event_t event;
+  uint8_t peer = (uint8_t)(uintptr_t)param;
+
+  MSS_BEGIN(MSS_TASK_CTX);
+
+  if(peer == TASK_B)
+  {
+    // TASK_A serves first
+    mss_event_set(peer, 0x01);
+  }
+
+  while(1)
+  {
+    MSS_EVENT_WAIT(event, MSS_TASK_CTX);
+    if(++ops < iterations)
+    {
+      mss_event_set(peer, event);
+    }
+  }
+
+  MSS_FINISH();
+}
+
+// semaphore handoff: the low priority holder (TASK_B) lets the high
+// priority waiter (TASK_A) block on the semaphore, then releases it
+static void sema_waiter_task(void* param)
+{
+  (void)param;
+
+  MSS_BEGIN(MSS_TASK_CTX);
+
+  while(1)
+  {
+    MSS_SEMA_WAIT(sema, MSS_TASK_CTX);
+    ops++;
+    mss_sema_post(sema);
+    MSS_RETURN(MSS_TASK_CTX);
+  }
+
+  MSS_FINISH();
+}
+
+static void sema_holder_task(void* param)
+{
+  (void)param;
+
+  MSS_BEGIN(MSS_TASK_CTX);
+
+  while(ops < iterations)
+  {
+    MSS_SEMA_WAIT(sema, MSS_TASK_CTX);
+
+    // let the waiter block on the semaphore
+    mss_activate_task(TASK_A);
+    mss_activate_task(TASK_B);
+    MSS_RETURN(MSS_TASK_CTX);
+
+    // hand over to the waiter
+    mss_sema_post(sema);
+    mss_activate_task(TASK_B);
+    MSS_RETURN(MSS_TASK_CTX);
+  }
+
+  MSS_FINISH();
+}
+
+// message queue echo: the owner (TASK_B) sends the message back to itself
+static void mque_task(void* param)
+{
+  mss_mque_msg_t* rx;
+
+  (void)param;
+
+  while((rx = mss_mque_read(mque)) != NULL)
+  {
+    if(++ops < iterations)
+    {
+      mss_mque_send(mque, rx);
+    }
+  }
+}
+
+//*****************************************************************************
+// Benchmarks
+//*****************************************************************************
+
+static void bench_dispatch(void)
+{
+  mss_task_create(TASK_A, self_task, NULL);
+  run_scheduler("task dispatch");
+  mss_task_delete(TASK_A);
+}
+
+static void bench_fanout(void)
+{
+  uint8_t i;
+
+  for(i=0 ; i<(MSS_NUM_OF_TASKS - 1) ; i++)
+  {
+    mss_task_create(i, fanout_leaf_task, NULL);
+  }
+  mss_task_create(MSS_NUM_OF_TASKS - 1, fanout_root_task, NULL);
+
+  // the leaf tasks have been activated by their creation
+  rounds = 0;
+  run_scheduler("dispatch, all slots ready");
+
+  for(i=0 ; i<MSS_NUM_OF_TASKS ; i++)
+  {
+    mss_task_delete(i);
+  }
+}
+
+static void bench_event(void)
+{
+  mss_task_create(TASK_A, event_task, (void*)(uintptr_t)TASK_B);
+  mss_task_create(TASK_B, event_task, (void*)(uintptr_t)TASK_A);
+  run_scheduler("event ping-pong");
+  mss_task_delete(TASK_A);
+  mss_task_delete(TASK_B);
+}
+
+static void bench_sema(void)
+{
+  sema = mss_sema_create(1);
+  mss_task_create(TASK_A, sema_waiter_task, NULL);
+  mss_task_create(TASK_B, sema_holder_task, NULL);
+  run_scheduler("semaphore handoff");
+  mss_task_delete(TASK_A);
+  mss_task_delete(TASK_B);
+}
+
+static void bench_mque(void)
+{
+  mque = mss_mque_create(TASK_B);
+  mss_task_create(TASK_B, mque_task, NULL);
+  mss_mque_send(mque, &msg);
+  run_scheduler("message queue send/read");
+  mss_task_delete(TASK_B);
+}
+
+static void bench_mem(void)
+{
+  unsigned long i;
+  uint64_t start;
+  void* block;
+
+  mem = mss_mem_create(16, 8);
+
+  start = now_ns();
+  for(i=0 ; i<iterations ; i++)
+  {
+    block = mss_mem_alloc(mem);
+    mss_mem_free(mem, block);
+  }
+  report("memory block alloc/free", iterations, now_ns() - start);
+}
+
+static void bench_timer(void)
+{
+  unsigned long i;
+  uint64_t start;
+  uint8_t t;
+
+  // the owner slot stays empty, expirations only set its ready bit
+  for(t=0 ; t<NUM_OF_BENCH_TIMERS ; t++)
+  {
+    timers[t] = mss_timer_create(TASK_TIMER_OWNER);
+    mss_timer_periodic_start(timers[t], 1 + t, 1 + t);
+  }
+
+  // start/stop of one timer among the running timers
+  start = now_ns();
+  for(i=0 ; i<iterations ; i++)
+  {
+    mss_timer_start(timers[0], 1 + (i & 0xFF));
+    mss_timer_stop(timers[0]);
+  }
+  report("timer start/stop (32 active)", iterations, now_ns() - start);
+  mss_timer_periodic_start(timers[0], 1, 1);
+
+  // timer tick processing with periodic expirations
+  start = now_ns();
+  for(i=0 ; i<iterations ; i++)
+  {
+    mss_timer_tick_cnt++;
+    mss_timer_tick();
+  }
+  report("timer tick (32 periodic)", iterations, now_ns() - start);
+
+  for(t=0 ; t<NUM_OF_BENCH_TIMERS ; t++)
+  {
+    mss_timer_stop(timers[t]);
+  }
+
+  // drop the activations of the empty owner slot
+  mss_scheduler();
+}
+
+//*****************************************************************************
+// Main
+//*****************************************************************************
+
+int main(int argc, char* argv[])
+{
+  iterations = DEFAULT_ITERATIONS;
+  if(argc > 1)
+  {
+    iterations = strtoul(argv[1], NULL, 0);
+  }
+
+  mss_init();
+
+  // the timer owner slot gets its timer here, the slot stays empty
+  mss_task_create(TASK_TIMER_OWNER, idle_task, NULL);
+  mss_scheduler();
+  mss_task_delete(TASK_TIMER_OWNER);
+
+  bench_dispatch();
+  bench_fanout();
+  bench_event();
+  bench_sema();
+  bench_mque();
+  bench_mem();
+  bench_timer();
+
+  return 0;
+}
@@ -0,0 +1,790 @@
+/******************************************************************************
+* MSS fleet simulator
+*
+* Runs thousands of lock nodes - each running the firmware from src with
+* MSS - on a thread pool to load-test a gateway against the real firmware
+* behavior. The firmware is built unchanged, single-instance, into the node
+* image fleet_node.so. Every node loads a copy of its own (written to a
+* temporary file under a name of its own, as the dynamic loader shares a
+* library loaded twice), so every node has its own copy of the firmware and
+* MSS variables and calls its copy through the entry points of fleet.h.
+*
+* Every node has its own virtual clock (simulation HAL): the motor delays of
+* the firmware take no host time. A work item is one command of a node; the
+* workers take items from the bottom of their own deque and steal from the
+* top of the other deques when they run out of work.
+*
+* Every node is programmed with an administrator key of its own, random
+* unless given with -k (the key of the pseudo-terminal nodes, for the
+* gateway). Nodes are driven by the built-in load generator (enrollment of a
+* random key with the administrator key at boot, then frames with lock, state
+* check and challenge, state check, unlock, state check and challenge, state
+* check; see src/Frame.h, src/Auth.h and src/Cred.h) through an in-memory
+* UART, which checks every reply frame. With -p the first nodes are bound to
+* pseudo-terminals instead and are driven by the gateway; the simulator then
+* runs until interrupted.
+*
+* usage: mss_fleet [-n nodes] [-c commands/node] [-t threads] [-p ptys]
+*                  [-i image] [-k admin key]
+******************************************************************************/
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fleet.h"
+#include "Motor.h"
+#include "Frame.h"
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+#define DEFAULT_NUM_OF_NODES     (1000)
+#define DEFAULT_CMDS_PER_NODE    (200)
+#define MAX_NUM_OF_NODES         (4096)
+
+// node image, next to the executable unless given with -i
+#define IMAGE_NAME               "fleet_node.so"
+
+// virtual time for the firmware to finish a lock/unlock command (the motor
+// move is queued, the reply does not wait for it) and a state check
+#define LOCK_CMD_TICKS           (10)
+#define CHECK_CMD_TICKS          (2)
+
+// reply of a challenge: opcode and nonce
+#define CHALLENGE_REPLY_LEN      (1 + AUTH_NONCE_LEN)
+
+typedef struct {
+  pthread_mutex_t lock;
+  uint32_t* items;              // ring buffer of node ids
+  uint32_t head, tail;          // top (steal) and bottom (owner) index
+  uint32_t size;
+} deque_t;
+
+typedef struct {
+  pthread_t thread;
+  uint32_t idx;
+  deque_t deque;
+  uint64_t cmds;
+  uint64_t steals;
+  uint64_t errors;
+  double busy_s;
+} worker_t;
+
+static fleet_node_t* fleet_nodes;
+
+// a node enrolls key id (FIRST_KEY_ID + node id) with the administrator key
+// at boot and is operated with it
+#define FIRST_KEY_ID             (0x0100)
+
+// administrator key of the pseudo-terminal nodes (-k), random if not given
+static uint32_t pty_admin_key[AUTH_KEY_WORDS];
+static uint8_t pty_admin_key_set = 0;
+
+static uint32_t num_of_nodes = DEFAULT_NUM_OF_NODES;
+static uint32_t num_of_ptys = 0;
+static uint32_t num_of_workers;
+static worker_t* workers;
+
+// generator nodes with commands left, 0 ends the run without pseudo-terminals
+static volatile uint32_t busy_nodes;
+static volatile sig_atomic_t stop = 0;
+
+//*****************************************************************************
+// Work stealing deque
+//*****************************************************************************
+
+static void deque_init(deque_t* dq, uint32_t size)
+{
+  pthread_mutex_init(&dq->lock, NULL);
+  dq->items = malloc(size * sizeof(uint32_t));
+  dq->head = dq->tail = 0;
+  dq->size = size;
+}
+
+// owner: push to the bottom
+static void deque_push(deque_t* dq, uint32_t item)
+{
+  pthread_mutex_lock(&dq->lock);
+  dq->items[dq->tail++ % dq->size] = item;
+  pthread_mutex_unlock(&dq->lock);
+}
+
+// owner: pop from the bottom (most recent node, cache hot)
+static int deque_pop(deque_t* dq, uint32_t* item)
+{
+  int ret = 0;
+
+  pthread_mutex_lock(&dq->lock);
+  if(dq->tail != dq->head)
+  {
+    *item = dq->items[--dq->tail % dq->size];
+    ret = 1;
+  }
+  pthread_mutex_unlock(&dq->lock);
+
+  return ret;
+}
+
+// thief: steal from the top (oldest node)
+static int deque_steal(deque_t* dq, uint32_t* item)
+{
+  int ret = 0;
+
+  if(pthread_mutex_trylock(&dq->lock) != 0)
+  {
+    return 0;
+  }
+  if(dq->tail != dq->head)
+  {
+    *item = dq->items[dq->head++ % dq->size];
+    ret = 1;
+  }
+  pthread_mutex_unlock(&dq->lock);
+
+  return ret;
+}
+
+//*****************************************************************************
+// Nodes
+//*****************************************************************************
+
+static double now_s(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+// frame with the given payload, bitwise CRC as a cross-check of the
+// firmware's table, returns the frame length
+static uint32_t frame_build(INT8U* frame, const INT8U* payload, uint8_t len)
+{
+  uint16_t crc = FRAME_CRC_INIT;
+  uint32_t i, bit;
+
+  frame[0] = FRAME_SOF;
+  frame[1] = len;
+  memcpy(&frame[2], payload, len);
+
+  for(i=1 ; i<(uint32_t)len+2 ; i++)
+  {
+    crc ^= (uint16_t)frame[i] << 8;
+    for(bit=0 ; bit<8 ; bit++)
+    {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                           : (uint16_t)(crc << 1);
+    }
+  }
+  frame[len + 2] = (INT8U)(crc >> 8);
+  frame[len + 3] = (INT8U)crc;
+
+  return len + 4;
+}
+
+// load a copy of the node image (image bytes) for the node, temporary
+// files in dir, returns 0 if the node has its entry points
+static int node_load(fleet_node_t* node, const char* dir,
+                     const void* image, size_t size)
+{
+  char path[PATH_MAX + 16];
+  void* handle;
+  FILE* f;
+
+  snprintf(path, sizeof(path), "%s/node-%u.so", dir, node->id);
+  f = fopen(path, "wb");
+  if((f == NULL) || (fwrite(image, 1, size, f) != size) || (fclose(f) != 0))
+  {
+    fprintf(stderr, "can not write %s\n", path);
+    return 1;
+  }
+
+  handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  unlink(path);
+  if(handle == NULL)
+  {
+    fprintf(stderr, "%s\n", dlerror());
+    return 1;
+  }
+
+  node->image.program = dlsym(handle, "fleet_board_program");
+  node->image.boot = dlsym(handle, "fleet_board_boot");
+  node->image.receive = dlsym(handle, "fleet_board_receive");
+  node->image.mac = dlsym(handle, "AuthMac");
+  node->image.crypt = dlsym(handle, "AuthCrypt");
+
+  return ((node->image.program == NULL) || (node->image.boot == NULL) ||
+          (node->image.receive == NULL) || (node->image.mac == NULL) ||
+          (node->image.crypt == NULL));
+}
+
+// read the whole node image, returns NULL if it can not be read
+static void* image_read(const char* path, size_t* size)
+{
+  FILE* f = fopen(path, "rb");
+  void* image = NULL;
+  long len;
+
+  if((f != NULL) && (fseek(f, 0, SEEK_END) == 0) && ((len = ftell(f)) > 0) &&
+     (fseek(f, 0, SEEK_SET) == 0) && ((image = malloc(len)) != NULL) &&
+     (fread(image, 1, len, f) == (size_t)len))
+  {
+    *size = (size_t)len;
+  }
+  else
+  {
+    free(image);
+    image = NULL;
+  }
+  if(f != NULL)
+  {
+    fclose(f);
+  }
+
+  return image;
+}
+
+// fetch the nonce of the next authenticated command
+static void node_challenge(fleet_node_t* node)
+{
+  INT8U payload[1] = { CHALLENGE_CH };
+  INT8U frame[1 + 4];
+  uint32_t len = frame_build(frame, payload, 1);
+
+  node->tx_len = 0;
+  node->image.receive(frame, len, CHECK_CMD_TICKS);
+  memcpy(node->nonce, &node->tx_buf[3], AUTH_NONCE_LEN);
+}
+
+// credentials (key id, tag over the last nonce, opcode and arguments) of
+// an authenticated command
+static void node_sign(fleet_node_t* node, INT16U key_id, const uint32_t* key,
+                      INT8U* cmd, uint8_t arg_len)
+{
+  INT8U msg[AUTH_NONCE_LEN + 1 + AUTH_ARG_MAX];
+  INT8U* cred = &cmd[1 + arg_len];
+
+  memcpy(msg, node->nonce, AUTH_NONCE_LEN);
+  memcpy(&msg[AUTH_NONCE_LEN], cmd, 1 + arg_len);
+  cred[0] = (INT8U)key_id;
+  cred[1] = (INT8U)(key_id >> 8);
+  node->image.mac(key, msg, AUTH_NONCE_LEN + 1 + arg_len,
+                  &cred[CRED_ID_LEN]);
+}
+
+// enroll the key of a node, encrypted with the administrator key, returns
+// 0 if the node accepted it
+static int node_enroll(fleet_node_t* node)
+{
+  INT8U payload[1 + CRED_ID_LEN + AUTH_KEY_LEN + AUTH_CRED_LEN];
+  INT8U frame[sizeof(payload) + 4];
+  uint32_t len;
+
+  payload[0] = ENROLL_CMD_CH;
+  payload[1] = (INT8U)node->key_id;
+  payload[2] = (INT8U)(node->key_id >> 8);
+  memcpy(&payload[1 + CRED_ID_LEN], node->key, AUTH_KEY_LEN);
+  node->image.crypt(node->admin_key, node->nonce, &payload[1 + CRED_ID_LEN]);
+  node_sign(node, CRED_ADMIN_ID, node->admin_key, payload,
+            CRED_ID_LEN + AUTH_KEY_LEN);
+  len = frame_build(frame, payload, sizeof(payload));
+
+  node->tx_len = 0;
+  node->image.receive(frame, len, CHECK_CMD_TICKS);
+  if(node->tx_buf[2] != ENROLL_CMD_CH || node->tx_buf[3] != DONE_CH)
+  {
+    return 1;
+  }
+  node_challenge(node);
+
+  return 0;
+}
+
+// program the administrator key of a node, boot its firmware and enroll
+// its key
+static void node_boot(fleet_node_t* node)
+{
+  if((node->pty_fd >= 0) && pty_admin_key_set)
+  {
+    memcpy(node->admin_key, pty_admin_key, sizeof(node->admin_key));
+  }
+  else if(getrandom(node->admin_key, sizeof(node->admin_key), 0) !=
+          sizeof(node->admin_key))
+  {
+    fprintf(stderr, "node %u: no random administrator key\n", node->id);
+  }
+  node->image.program(node->admin_key);
+  node->image.boot(node);
+
+  node_challenge(node);
+
+  // nodes on pseudo-terminals are enrolled by the gateway
+  node->key_id = FIRST_KEY_ID + node->id;
+  if(getrandom(node->key, sizeof(node->key), 0) != sizeof(node->key))
+  {
+    fprintf(stderr, "node %u: no random key\n", node->id);
+  }
+  if((node->pty_fd < 0) && (node_enroll(node) != 0))
+  {
+    fprintf(stderr, "node %u: enrollment failed\n", node->id);
+  }
+}
+
+// one command frame of the load generator, returns 0 if the reply was
+// correct
+static int node_command(fleet_node_t* node)
+{
+  INT8U payload[FRAME_MAX_PAYLOAD];
+  INT8U frame[FRAME_MAX_PAYLOAD + 4];
+  INT8U expected[2 * (FRAME_MAX_PAYLOAD + 4)];
+  INT8U report[1 + MOTOR_REPORT_LEN];
+  uint32_t len, expected_len, nonce_pos = 0;
+  uint64_t settle;
+  INT8U state;
+  INT16U time;
+
+  node->tx_len = 0;
+
+  switch(node->cmd_idx++ & 0x03)
+  {
+  case 0:
+  case 2:
+    // lock or unlock with the key id and the tag over the last nonce, a
+    // state check and the next challenge in one frame
+    payload[0] = node->locked ? UNLOCK_CMD_CH : LOCK_CMD_CH;
+    node_sign(node, node->key_id, node->key, payload, 0);
+    payload[AUTH_CRED_LEN + 1] = STATE_CHECK_CH;
+    payload[AUTH_CRED_LEN + 2] = CHALLENGE_CH;
+    len = frame_build(frame, payload, AUTH_CRED_LEN + 3);
+    node->locked = !node->locked;
+    state = node->locked ? STATE_LOCKED_CH : STATE_UNLOCKED_CH;
+    payload[1] = state;
+    payload[2] = STATE_CHECK_CH;
+    payload[3] = state;
+    payload[4] = CHALLENGE_CH;
+    // the nonce is not known in advance, take it from the reply
+    nonce_pos = 2 + 5;
+    memset(&payload[5], 0, AUTH_NONCE_LEN);
+    expected_len = frame_build(expected, payload, 4 + CHALLENGE_REPLY_LEN);
+    // the move ends at once (fleet_board.c), its report follows the reply
+    time = node->locked ? MOTOR_TIME_OUT : MOTOR_TIME_IN;
+    report[0] = MOTOR_REPORT_CH;
+    report[1] = MOTOR_TIMEOUT_CH;
+    report[2] = (INT8U)time;
+    report[3] = (INT8U)(time >> 8);
+    report[4] = 0;
+    report[5] = 0;
+    expected_len += frame_build(&expected[expected_len], report,
+                                sizeof(report));
+    settle = LOCK_CMD_TICKS;
+    break;
+
+  default:
+    // state check
+    payload[0] = STATE_CHECK_CH;
+    len = frame_build(frame, payload, 1);
+    payload[1] = node->locked ? STATE_LOCKED_CH : STATE_UNLOCKED_CH;
+    expected_len = frame_build(expected, payload, 2);
+    settle = CHECK_CMD_TICKS;
+    break;
+  }
+
+  node->image.receive(frame, len, settle);
+
+  if(node->tx_len != expected_len)
+  {
+    return 1;
+  }
+  if(nonce_pos > 0)
+  {
+    memcpy(node->nonce, &node->tx_buf[nonce_pos], AUTH_NONCE_LEN);
+    memcpy(&payload[5], node->nonce, AUTH_NONCE_LEN);
+    frame_build(expected, payload, 4 + CHALLENGE_REPLY_LEN);
+  }
+
+  return (memcmp(node->tx_buf, expected, expected_len) == 0) ? 0 : 1;
+}
+
+// bytes from the pseudo-terminal, no reply check
+static void node_pty_input(fleet_node_t* node)
+{
+  INT8U bytes[FLEET_RX_QUEUE_SIZE];
+  uint16_t len;
+
+  pthread_mutex_lock(&node->rx_lock);
+  len = node->rx_len;
+  memcpy(bytes, node->rx_queue, len);
+  node->rx_len = 0;
+  node->queued = 0;
+  pthread_mutex_unlock(&node->rx_lock);
+
+  node->image.receive(bytes, len, LOCK_CMD_TICKS);
+}
+
+//*****************************************************************************
+// Workers
+//*****************************************************************************
+
+static int get_work(worker_t* w, uint32_t* node_id)
+{
+  uint32_t i, victim;
+
+  if(deque_pop(&w->deque, node_id))
+  {
+    return 1;
+  }
+
+  for(i=1 ; i<num_of_workers ; i++)
+  {
+    victim = (w->idx + i) % num_of_workers;
+    if(deque_steal(&workers[victim].deque, node_id))
+    {
+      w->steals++;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static void* worker_main(void* arg)
+{
+  worker_t* w = (worker_t*)arg;
+  struct timespec idle = { 0, 100000 };
+  fleet_node_t* node;
+  uint32_t node_id;
+  double start;
+
+  while(!stop)
+  {
+    if(!get_work(w, &node_id))
+    {
+      if((busy_nodes == 0) && (num_of_ptys == 0))
+      {
+        break;
+      }
+      nanosleep(&idle, NULL);
+      continue;
+    }
+
+    start = now_s();
+    node = &fleet_nodes[node_id];
+
+    if(node->pty_fd >= 0)
+    {
+      node_pty_input(node);
+    }
+    else
+    {
+      w->errors += node_command(node);
+      w->cmds++;
+
+      if(--node->cmds_left > 0)
+      {
+        deque_push(&w->deque, node_id);
+      }
+      else
+      {
+        __sync_fetch_and_sub(&busy_nodes, 1);
+      }
+    }
+    w->busy_s += now_s() - start;
+  }
+
+  return NULL;
+}
+
+//*****************************************************************************
+// Pseudo-terminals
+//*****************************************************************************
+
+static int open_pty(fleet_node_t* node)
+{
+  int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+  if((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0))
+  {
+    return -1;
+  }
+
+  printf("node %u: %s\n", node->id, ptsname(fd));
+  node->pty_fd = fd;
+
+  return 0;
+}
+
+// reads the pseudo-terminals and queues the nodes with received bytes
+static void* pty_main(void* arg)
+{
+  struct pollfd* fds = calloc(num_of_ptys, sizeof(struct pollfd));
+  fleet_node_t* node;
+  INT8U buf[64];
+  ssize_t len, i;
+  uint32_t n, next_worker = 0;
+  int schedule;
+
+  (void)arg;
+
+  for(n=0 ; n<num_of_ptys ; n++)
+  {
+    fds[n].fd = fleet_nodes[n].pty_fd;
+    fds[n].events = POLLIN;
+  }
+
+  while(!stop)
+  {
+    if(poll(fds, num_of_ptys, 100) <= 0)
+    {
+      continue;
+    }
+
+    for(n=0 ; n<num_of_ptys ; n++)
+    {
+      if(!(fds[n].revents & POLLIN))
+      {
+        continue;
+      }
+
+      node = &fleet_nodes[n];
+      len = read(node->pty_fd, buf, sizeof(buf));
+
+      pthread_mutex_lock(&node->rx_lock);
+      for(i=0 ; (i<len) && (node->rx_len<FLEET_RX_QUEUE_SIZE) ; i++)
+      {
+        node->rx_queue[node->rx_len++] = buf[i];
+      }
+      schedule = (len > 0) && !node->queued;
+      node->queued |= schedule;
+      pthread_mutex_unlock(&node->rx_lock);
+
+      if(schedule)
+      {
+        deque_push(&workers[next_worker++ % num_of_workers].deque, n);
+      }
+    }
+  }
+
+  free(fds);
+
+  return NULL;
+}
+
+static void on_signal(int sig)
+{
+  (void)sig;
+  stop = 1;
+}
+
+//*****************************************************************************
+// Main
+//*****************************************************************************
+
+// key given as hex digits, bytes in memory order (tools/cred_provision.py),
+// returns 0 if valid
+static int parse_key(const char* hex, uint32_t* key)
+{
+  INT8U* b = (INT8U*)key;
+  unsigned int byte;
+  uint8_t i;
+
+  if((strlen(hex) != 2 * AUTH_KEY_LEN) ||
+     (strspn(hex, "0123456789abcdefABCDEF") != 2 * AUTH_KEY_LEN))
+  {
+    return 1;
+  }
+  for(i=0 ; i<AUTH_KEY_LEN ; i++)
+  {
+    if(sscanf(&hex[2 * i], "%2x", &byte) != 1)
+    {
+      return 1;
+    }
+    b[i] = (INT8U)byte;
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t cmds_per_node = DEFAULT_CMDS_PER_NODE;
+  char image_path[PATH_MAX], tmp_dir[PATH_MAX];
+  const char* tmp = getenv("TMPDIR");
+  char* name;
+  void* image;
+  size_t image_size;
+  ssize_t len;
+  uint32_t n, i;
+  uint64_t cmds = 0, steals = 0, errors = 0, actuations = 0;
+  pthread_t pty_thread;
+  double start, wall, busy = 0.0;
+  int opt;
+
+  num_of_workers = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+
+  // the node image next to the executable
+  len = readlink("/proc/self/exe", image_path, sizeof(image_path) - 1);
+  image_path[(len > 0) ? len : 0] = 0;
+  name = strrchr(image_path, '/');
+  name = (name != NULL) ? name + 1 : image_path;
+  snprintf(name, sizeof(image_path) - (size_t)(name - image_path), "%s",
+           IMAGE_NAME);
+
+  while((opt = getopt(argc, argv, "n:c:t:p:i:k:")) != -1)
+  {
+    switch(opt)
+    {
+    case 'n': num_of_nodes = strtoul(optarg, NULL, 0); break;
+    case 'c': cmds_per_node = strtoul(optarg, NULL, 0); break;
+    case 't': num_of_workers = strtoul(optarg, NULL, 0); break;
+    case 'p': num_of_ptys = strtoul(optarg, NULL, 0); break;
+    case 'i': snprintf(image_path, sizeof(image_path), "%s", optarg); break;
+    case 'k':
+      if(parse_key(optarg, pty_admin_key) != 0)
+      {
+        fprintf(stderr, "-k: %d hex digits\n", 2 * AUTH_KEY_LEN);
+        return 2;
+      }
+      pty_admin_key_set = 1;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-n nodes] [-c commands/node] "
+              "[-t threads] [-p ptys] [-i image] [-k admin key]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if((num_of_nodes == 0) || (num_of_nodes > MAX_NUM_OF_NODES) ||
+     (num_of_ptys > num_of_nodes) || (num_of_workers == 0) ||
+     (cmds_per_node == 0))
+  {
+    fprintf(stderr, "1 .. %d nodes, at most one pty per node, at least "
+            "one command per node\n", MAX_NUM_OF_NODES);
+    return 2;
+  }
+
+  image = image_read(image_path, &image_size);
+  snprintf(tmp_dir, sizeof(tmp_dir), "%s/mss_fleet.XXXXXX",
+           (tmp != NULL) ? tmp : "/tmp");
+  if((image == NULL) || (mkdtemp(tmp_dir) == NULL))
+  {
+    fprintf(stderr, "can not read %s\n", image_path);
+    return 2;
+  }
+
+  // the pseudo-terminal names are read by the gateway test scripts
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+
+  fleet_nodes = calloc(num_of_nodes, sizeof(fleet_node_t));
+  workers = calloc(num_of_workers, sizeof(worker_t));
+
+  for(i=0 ; i<num_of_workers ; i++)
+  {
+    workers[i].idx = i;
+    deque_init(&workers[i].deque, num_of_nodes);
+  }
+
+  for(n=0 ; n<num_of_nodes ; n++)
+  {
+    fleet_nodes[n].id = (uint16_t)n;
+    fleet_nodes[n].pty_fd = -1;
+    pthread_mutex_init(&fleet_nodes[n].rx_lock, NULL);
+    if(node_load(&fleet_nodes[n], tmp_dir, image, image_size) != 0)
+    {
+      rmdir(tmp_dir);
+      return 2;
+    }
+    if((n < num_of_ptys) && (open_pty(&fleet_nodes[n]) != 0))
+    {
+      fprintf(stderr, "can not open a pseudo-terminal\n");
+      return 2;
+    }
+
+    node_boot(&fleet_nodes[n]);
+
+    if(fleet_nodes[n].pty_fd < 0)
+    {
+      // uneven load per node, balanced by work stealing, at least one
+      // command: a queued node counts down before it checks for 0
+      fleet_nodes[n].cmds_left = cmds_per_node / 2 +
+                                 (uint32_t)((n * 2654435761UL) %
+                                            (cmds_per_node + 1));
+      if(fleet_nodes[n].cmds_left == 0)
+      {
+        fleet_nodes[n].cmds_left = 1;
+      }
+      busy_nodes++;
+      deque_push(&workers[n % num_of_workers].deque, n);
+    }
+  }
+
+  rmdir(tmp_dir);
+  free(image);
+
+  if(num_of_ptys > 0)
+  {
+    pthread_create(&pty_thread, NULL, pty_main, NULL);
+    printf("serving %u pseudo-terminals, Ctrl-C to stop\n", num_of_ptys);
+  }
+
+  start = now_s();
+  for(i=0 ; i<num_of_workers ; i++)
+  {
+    pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+  }
+  for(i=0 ; i<num_of_workers ; i++)
+  {
+    pthread_join(workers[i].thread, NULL);
+  }
+  wall = now_s() - start;
+
+  stop = 1;
+  if(num_of_ptys > 0)
+  {
+    pthread_join(pty_thread, NULL);
+  }
+
+  for(i=0 ; i<num_of_workers ; i++)
+  {
+    printf("worker %2u: %10llu commands %8llu steals %6.1f %% busy\n", i,
+           (unsigned long long)workers[i].cmds,
+           (unsigned long long)workers[i].steals,
+           100.0 * workers[i].busy_s / wall);
+    cmds += workers[i].cmds;
+    steals += workers[i].steals;
+    errors += workers[i].errors;
+    busy += workers[i].busy_s;
+  }
+  for(n=0 ; n<num_of_nodes ; n++)
+  {
+    actuations += fleet_nodes[n].actuations;
+  }
+
+  printf("nodes                    %u (%u on pseudo-terminals)\n",
+         num_of_nodes, num_of_ptys);
+  printf("threads                  %u\n", num_of_workers);
+  printf("commands                 %llu\n", (unsigned long long)cmds);
+  printf("motor actuations         %llu\n", (unsigned long long)actuations);
+  printf("steals                   %llu\n", (unsigned long long)steals);
+  printf("wrong replies            %llu\n", (unsigned long long)errors);
+  printf("wall time                %.3f s\n", wall);
+  printf("commands/s               %.0f\n", cmds / wall);
+  printf("commands/s per core      %.0f\n", cmds / wall / num_of_workers);
+  printf("commands/s per busy core %.0f\n", busy > 0.0 ? cmds / busy : 0.0);
+
+  return (errors == 0) ? 0 : 1;
+}
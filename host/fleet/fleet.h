@@ -0,0 +1,84 @@
+/******************************************************************************
+* MSS fleet simulator - simulated lock node
+*
+* Every node is a copy of the node image (fleet_node.so: the unchanged
+* firmware from src, MSS on the simulation HAL and fleet_board.c) loaded on
+* its own, so it has its own copy of every firmware and MSS variable. The
+* board gives it an in-memory UART and motor or a pseudo-terminal.
+******************************************************************************/
+
+#ifndef _FLEET_H_
+#define _FLEET_H_
+
+#include <pthread.h>
+
+#include "includes.h"
+#include "mss/mss.h"
+#include "Auth.h"
+#include "Cred.h"
+
+// size of the transmit buffer of a node
+#define FLEET_TX_BUF_SIZE        (80)
+
+// size of the receive queue of a pseudo-terminal node
+#define FLEET_RX_QUEUE_SIZE      (256)
+
+typedef struct fleet_node fleet_node_t;
+
+/** fleet_image_t
+ *  entry points of the loaded copy of the node image
+ */
+typedef struct {
+  // write the administrator key into the flash of the node, like the
+  // programming of a device (fleet_board_program)
+  void (*program)(const uint32_t* admin_key);
+
+  // boot the firmware of the node (fleet_board_boot)
+  void (*boot)(fleet_node_t* node);
+
+  // feed received bytes into the node and run it until it has settled
+  // (fleet_board_receive)
+  void (*receive)(const INT8U* bytes, uint32_t len, uint64_t settle);
+
+  // MAC and key encryption of the firmware (AuthMac, AuthCrypt)
+  void (*mac)(const uint32_t* key, const INT8U* msg, INT8U len, INT8U* tag);
+  void (*crypt)(const uint32_t* key, const INT8U* nonce, INT8U* data);
+} fleet_image_t;
+
+struct fleet_node {
+  uint16_t id;                  // node number
+  fleet_image_t image;          // own copy of the firmware
+
+  // UART (fleet_board.c)
+  INT8U tx_buf[FLEET_TX_BUF_SIZE];
+  uint8_t tx_len;
+  int pty_fd;                   // master side, -1 for in-memory UART
+
+  // motor (fleet_board.c)
+  uint8_t motor_enabled;
+  uint8_t motor_out;
+  uint32_t actuations;
+  uint8_t motor_done;           // reports not taken by MotorDone
+
+  // load generator
+  uint32_t cmds_left;
+  uint32_t cmd_idx;
+  uint8_t locked;
+  INT8U nonce[AUTH_NONCE_LEN];  // of the next authenticated command
+  uint32_t admin_key[AUTH_KEY_WORDS];  // programmed into the node
+  INT16U key_id;                // enrolled at boot by the administrator
+  uint32_t key[AUTH_KEY_WORDS];
+
+  // bytes received from the pseudo-terminal, scheduled flag
+  pthread_mutex_t rx_lock;
+  INT8U rx_queue[FLEET_RX_QUEUE_SIZE];
+  uint16_t rx_len;
+  uint8_t queued;
+};
+
+// entry points of the node image (fleet_board.c)
+void fleet_board_program(const uint32_t* admin_key);
+void fleet_board_boot(fleet_node_t* node);
+void fleet_board_receive(const INT8U* bytes, uint32_t len, uint64_t settle);
+
+#endif /* _FLEET_H_ */
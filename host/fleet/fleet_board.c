@@ -0,0 +1,189 @@
+/******************************************************************************
+* MSS fleet simulator - board of a simulated lock node
+*
+* Host replacement of the MSP430 drivers UART.c and Motor.c for the
+* firmware in src/main.c, and the entry points of the node image. Every
+* loaded copy of the image is one node and works on the node given to
+* fleet_board_boot. The UART transmits into the node's buffer (or to its
+* pseudo-terminal), the receive interrupt is a scripted interrupt of the
+* simulation HAL.
+******************************************************************************/
+
+#include <unistd.h>
+
+#include "fleet.h"
+#include "UART.h"
+#include "Motor.h"
+#include "Frame.h"
+#include "Flash.h"
+#include "Journal.h"
+#include "Audit.h"
+
+// scripted interrupt line of the UART receive interrupt
+#define FLEET_IRQ_UART_RX        (0)
+
+// virtual time between two received bytes (ticks, >= 1 byte at 115200 Bd)
+#define BYTE_TICKS               (1)
+
+// node of this copy of the image
+static fleet_node_t* node;
+
+static void uart_rx_isr(uint16_t arg);
+
+//*****************************************************************************
+// Node
+//*****************************************************************************
+
+// write the administrator key into information memory segment D, like
+// tools/cred_provision.py does for a device
+void fleet_board_program(const uint32_t* admin_key)
+{
+  uint8_t i;
+
+  FlashEraseSegment(CRED_ADMIN_KEY);
+  for(i=0 ; i<AUTH_KEY_WORDS ; i++)
+  {
+    FlashWriteWord(CRED_ADMIN_KEY + (i * 4), (INT16U)admin_key[i]);
+    FlashWriteWord(CRED_ADMIN_KEY + (i * 4) + 2, (INT16U)(admin_key[i] >> 16));
+  }
+}
+
+// boot the firmware of the node, like main() of src/main.c
+void fleet_board_boot(fleet_node_t* n)
+{
+  node = n;
+
+  mss_hal_sim_set_isr(FLEET_IRQ_UART_RX, uart_rx_isr);
+
+  UARTInit();
+  FrameInit();
+  mss_init();
+  FlashInit();
+  CredInit();
+  JournalInit();
+  AuditInit();
+  AuthInit();
+  MotorInit();
+  InitControlTasks();
+
+  // let the ControlTask run its first activation
+  mss_hal_sim_run(0);
+}
+
+// feed received bytes into the node and run it until it has settled
+void fleet_board_receive(const INT8U* bytes, uint32_t len, uint64_t settle)
+{
+  uint64_t t = mss_hal_sim_get_time();
+  uint32_t i;
+
+  for(i=0 ; i<len ; i++)
+  {
+    mss_hal_sim_inject(t + ((i + 1) * BYTE_TICKS), FLEET_IRQ_UART_RX,
+                       bytes[i]);
+  }
+
+  mss_hal_sim_run(t + (len * BYTE_TICKS) + settle);
+}
+
+//*****************************************************************************
+// UART
+//*****************************************************************************
+
+void UARTInit(void)
+{
+  node->tx_len = 0;
+}
+
+void UARTPutChar(INT8U ch)
+{
+  if(node->pty_fd >= 0)
+  {
+    // the gateway reads the pseudo-terminal, drop if it does not
+    if(write(node->pty_fd, &ch, 1) < 0)
+    {
+      node->tx_len = 0;
+    }
+    return;
+  }
+
+  if(node->tx_len < FLEET_TX_BUF_SIZE)
+  {
+    node->tx_buf[node->tx_len++] = ch;
+  }
+}
+
+void UARTPutStr(const INT8U *str)
+{
+  while(*str != 0x00)
+  {
+    UARTPutChar(*str++);
+  }
+}
+
+// same as USCI0RX_ISR of UART.c
+static void uart_rx_isr(uint16_t arg)
+{
+  if(FrameRxByte((INT8U)arg) == TRUE)
+  {
+    mss_activate_task(CNTL_TSK_ID);
+    MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_UART);
+  }
+}
+
+//*****************************************************************************
+// Motor
+//*****************************************************************************
+
+void MotorInit(void)
+{
+  // the motor stays where it is, like the firmware
+  node->motor_enabled = 0;
+  node->actuations = 0;
+  node->motor_done = 0;
+}
+
+void MotorHome(void)
+{
+  node->motor_out = 0;
+}
+
+INT8U MotorIn(void)
+{
+  // a move takes no simulated time and ends at once, count actuations
+  node->motor_out = 0;
+  node->actuations++;
+  node->motor_done++;
+  mss_event_set(CNTL_TSK_ID, MOTOR_EVENT_DONE);
+  return TRUE;
+}
+
+INT8U MotorOut(void)
+{
+  node->motor_out = 1;
+  node->actuations++;
+  node->motor_done++;
+  mss_event_set(CNTL_TSK_ID, MOTOR_EVENT_DONE);
+  return TRUE;
+}
+
+void MotorReport(INT8U* buf)
+{
+  INT16U time = node->motor_out ? MOTOR_TIME_OUT : MOTOR_TIME_IN;
+
+  buf[0] = MOTOR_TIMEOUT_CH;
+  buf[1] = time & 0xFF;
+  buf[2] = time >> 8;
+  buf[3] = 0;
+  buf[4] = 0;
+}
+
+INT8U MotorDone(INT8U* buf)
+{
+  if(node->motor_done == 0)
+  {
+    return FALSE;
+  }
+  node->motor_done--;
+  MotorReport(buf);
+  return TRUE;
+}
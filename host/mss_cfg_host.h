@@ -0,0 +1,94 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_cfg_host.h
+* 
+* @brief    mcu simple scheduler configuration of the host (POSIX) build
+* 
+* @version  0.2.1
+* 
+* @remark   selected by host/Makefile with -DMSS_CFG_FILE="mss_cfg_host.h"
+*           and included at the end of src/mss/mss_cfg.h: only the values
+*           which differ from the target configuration are redefined. All
+*           modules are enabled and sized for the benchmarks.
+* 
+******************************************************************************/
+
+#ifndef _MSS_CFG_HOST_H_
+#define _MSS_CFG_HOST_H_
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+// target configuration, the values below replace some of it
+#include "mss_cfg.h"
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+#undef  MSS_NUM_OF_TASKS
+#define MSS_NUM_OF_TASKS                 (32)
+
+#undef  MSS_TASK_USE_MQUE
+#define MSS_TASK_USE_MQUE                (TRUE)
+
+#undef  MSS_TASK_USE_SEMA
+#define MSS_TASK_USE_SEMA                (TRUE)
+
+#undef  MSS_TASK_USE_RWLOCK
+#define MSS_TASK_USE_RWLOCK              (TRUE)
+
+#undef  MSS_TASK_USE_BARRIER
+#define MSS_TASK_USE_BARRIER             (TRUE)
+
+#undef  MSS_TASK_USE_MEM
+#define MSS_TASK_USE_MEM                 (TRUE)
+
+#undef  MSS_MAX_NUM_OF_TIMER
+#define MSS_MAX_NUM_OF_TIMER             (2048)
+
+#undef  MSS_MAX_NUM_OF_MQUE
+#define MSS_MAX_NUM_OF_MQUE              (4)
+
+#undef  MSS_MAX_NUM_OF_SEMA
+#define MSS_MAX_NUM_OF_SEMA              (4)
+
+#undef  MSS_MAX_NUM_OF_RWLOCK
+#define MSS_MAX_NUM_OF_RWLOCK            (2)
+
+#undef  MSS_MAX_NUM_OF_BARRIER
+#define MSS_MAX_NUM_OF_BARRIER           (2)
+
+#undef  MSS_MAX_NUM_OF_MEM
+#define MSS_MAX_NUM_OF_MEM               (2)
+
+#endif /* _MSS_CFG_HOST_H_*/
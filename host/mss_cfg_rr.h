@@ -0,0 +1,76 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_cfg_rr.h
+* 
+* @brief    mcu simple scheduler configuration of the round-robin variant
+*           of mss_sim
+* 
+* @version  0.2.1
+* 
+* @remark   selected by host/Makefile for build/mss_sim_rr: the host
+*           configuration with four tasks per priority level, so that
+*           mss_sim checks the round-robin order within a level
+* 
+******************************************************************************/
+
+#ifndef _MSS_CFG_RR_H_
+#define _MSS_CFG_RR_H_
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+// host configuration, the values below replace some of it
+#include "mss_cfg_host.h"
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+#undef  MSS_TASKS_PER_PRIO_LEVEL
+#define MSS_TASKS_PER_PRIO_LEVEL         (4)
+
+#undef  MSS_TASK_STATS
+#define MSS_TASK_STATS                   (TRUE)
+
+#undef  MSS_TRACE
+#define MSS_TRACE                        (TRUE)
+
+// all records of the round-robin scenario
+#define MSS_TRACE_BUF_SIZE               (512)
+
+#undef  MSS_POWER_STATS
+#define MSS_POWER_STATS                  (TRUE)
+
+#undef  MSS_LATENCY_STATS
+#define MSS_LATENCY_STATS                (TRUE)
+
+#endif /* _MSS_CFG_RR_H_*/
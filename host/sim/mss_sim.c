@@ -0,0 +1,806 @@
+/******************************************************************************
+* MSS virtual-time simulation test
+*
+* Runs the scheduler and the timer module on the simulation HAL
+* (mss_hal_sim.c): hours of device time pass in a fraction of a second since
+* mss_hal_sleep jumps straight to the next timer deadline.
+*
+* - a few thousand one-shot and periodic timers with random periods up to
+*   the maximum of half the tick range run across many wraparounds of
+*   mss_timer_tick_cnt; every expiration is checked against its expected
+*   virtual time, so an ordering error of timer_cmp at MSB_TMR_MASK shows
+*   up as a late or missed expiration
+* - scripted interrupts from a test file feed an interrupt task and start
+*   one-shot timers at fixed virtual times
+* - before the run, a periodic timer gets one late tick which spans several
+*   periods: it shall end up in the overflow state and still be unlinked by
+*   mss_timer_stop
+* - with MSS_POWER_STATS, the sleep time shall be the virtual time of the
+*   run and every wake-up shall be counted once with its source
+* - with MSS_LATENCY_STATS, the latency from every received byte to the
+*   start of the interrupt task shall be measured once
+* - after the run, scenarios of the scheduler options of the configuration
+*   (MSS_CFG_FILE, see host/Makefile for the variants): with more than one
+*   task per priority level, the ready tasks of a level shall run in turn
+*   and their task statistics shall count every run and reactivation;
+*   the trace shall record the same task starts as the scenario tasks log;
+*   with EDF scheduling, the tasks shall run in the order of the deadlines
+*   of their jobs and a task which polls past its deadline shall count one
+*   deadline miss, with the polling time counted as active time
+*
+* The host time per simulated event (timer expiration or interrupt) is the
+* scheduler and timer module cost. The checksum over all expirations shall
+* be the same for every run with the same parameters.
+*
+* usage: mss_sim [hours] [timers] [script]
+*
+* exit status 0 if all expirations and interrupts have been served in time
+******************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "mss.h"
+#include "mss_int.h"
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+#define DEFAULT_HOURS            (2)
+#define DEFAULT_NUM_OF_TIMERS    (1000)
+#define DEFAULT_SCRIPT           "sim/irq_script.txt"
+
+// timer ticks of one hour
+#define TICKS_PER_HOUR           (3600UL * 1000UL / MSS_TIMER_TICK_MS)
+
+// maximum timer period (half of the tick range minus one)
+#define MAX_PERIOD               ((mss_timer_tick_t)(MSB_TICK - 1))
+#define MSB_TICK                 ((mss_timer_tick_t)1 << \
+                                  ((sizeof(mss_timer_tick_t) * 8) - 1))
+
+// task ids: the timer tasks share the timers, the interrupt task serves
+// the scripted interrupts
+#define NUM_OF_TIMER_TASKS       (MSS_NUM_OF_TASKS - 2)
+#define IRQ_TASK_ID              (MSS_NUM_OF_TASKS - 2)
+
+// latency measurement source of the received bytes
+#define LATENCY_SRC_RX_BYTE      (0)
+
+// scripted interrupt lines
+#define IRQ_RX_BYTE              (0)   // arg: received byte
+#define IRQ_START_TIMER          (1)   // arg: one-shot timer ticks
+#define IRQ_SCENARIO             (2)   // arg: step of the running scenario
+
+// timers reserved by the task slots (one per task slot)
+#define NUM_OF_TASK_TIMERS       (MSS_NUM_OF_TASKS)
+
+typedef struct {
+  mss_timer_t hdl;
+  uint64_t expected;            // virtual time of the next expiration
+  mss_timer_tick_t reload;      // 0: one-shot, restarted with a new period
+} sim_timer_t;
+
+static sim_timer_t* timers;
+static uint32_t num_of_timers;
+
+// interrupt timer, started by IRQ_START_TIMER
+static sim_timer_t irq_timer;
+
+// received bytes and their arrival times
+static uint16_t rx_byte;
+static uint64_t rx_time;
+static bool rx_pending = false;
+
+static uint32_t rng_state = 0x12345678UL;
+
+static unsigned long expirations, irqs, rx_irqs, errors;
+static uint32_t checksum = 2166136261UL;
+
+#if (MSS_POWER_STATS == TRUE)
+// sleep time of the main run
+static uint32_t sleep_ticks;
+#endif
+
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1) || (MSS_EDF_SCHEDULING == TRUE)
+#define SIM_SCENARIOS
+#endif
+
+#if defined(SIM_SCENARIOS)
+// step function of the scheduler scenario which runs after the main run,
+// called from the IRQ_SCENARIO interrupt
+static void (*scenario_step)(uint16_t step);
+#endif
+
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+// round-robin scenario: the tasks of level 0 stay ready for RR_ROUNDS runs
+// each, the task of level 1 is ready all the time
+#define RR_ROUNDS                (20)
+#define RR_LOW_TASK_ID           (MSS_TASKS_PER_PRIO_LEVEL)
+#define RR_LOG_LEN               ((RR_ROUNDS * MSS_TASKS_PER_PRIO_LEVEL) + 1)
+
+static uint8_t rr_log[RR_LOG_LEN];
+static uint16_t rr_log_len;
+static uint16_t rr_runs[MSS_TASKS_PER_PRIO_LEVEL];
+#endif /* (MSS_TASKS_PER_PRIO_LEVEL > 1) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+// EDF scenario: four tasks run in the order of their job deadlines, the
+// polling task overruns its deadline once
+#define EDF_NUM_OF_TASKS         (4)
+#define EDF_POLL_TASK_ID         (2)
+#define EDF_POLL_TICKS           (40)
+
+static uint8_t edf_log[EDF_NUM_OF_TASKS];
+static uint16_t edf_log_len;
+static bool edf_poll;
+static uint16_t edf_misses;
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
+//*****************************************************************************
+// Helper functions
+//*****************************************************************************
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+// xorshift32, deterministic across runs
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+// random period, mostly long ones which cross MSB_TMR_MASK
+static mss_timer_tick_t random_period(void)
+{
+  uint32_t r = rng();
+
+  if((r & 0x3F) == 0)
+  {
+    return (mss_timer_tick_t)(1 + ((r >> 8) % 1000));
+  }
+
+  return (mss_timer_tick_t)(MAX_PERIOD - ((r >> 8) % (MAX_PERIOD / 2)));
+}
+
+static void add_checksum(uint64_t value)
+{
+  checksum = (checksum ^ (uint32_t)value) * 16777619UL;
+}
+
+static void error(const char* what, uint32_t idx, uint64_t expected)
+{
+  if(errors++ < 10)
+  {
+    printf("ERROR: %s, timer %lu expected at %llu, now %llu\n", what,
+           (unsigned long)idx, (unsigned long long)expected,
+           (unsigned long long)mss_hal_sim_get_time());
+  }
+}
+
+// check and restart an expired timer, report missed expirations
+static void check_timer(sim_timer_t* tmr, uint32_t idx)
+{
+  uint64_t now = mss_hal_sim_get_time();
+  mss_timer_state_t state = mss_timer_get_state(tmr->hdl);
+  mss_timer_tick_t period;
+
+  if(state & (MSS_TIMER_STATE_EXPIRED_ONE_SHOT |
+              MSS_TIMER_STATE_EXPIRED_PERIODIC))
+  {
+    if(now != tmr->expected)
+    {
+      error("wrong expiration time", idx, tmr->expected);
+    }
+
+    expirations++;
+    add_checksum(now);
+
+    if(tmr->reload > 0)
+    {
+      tmr->expected += tmr->reload;
+    }
+    else if(tmr != &irq_timer)
+    {
+      period = random_period();
+      mss_timer_start(tmr->hdl, period);
+      tmr->expected = now + period;
+    }
+  }
+  else if(state & MSS_TIMER_STATE_OVERFLOW)
+  {
+    error("expiration not served", idx, tmr->expected);
+  }
+  else if((state != MSS_TIMER_STATE_IDLE) && (now > tmr->expected))
+  {
+    error("missed expiration", idx, tmr->expected);
+    mss_timer_stop(tmr->hdl);
+  }
+}
+
+// a late tick serves a periodic timer once per missed period, its state
+// shall saturate at overflow and it shall stay in the active timer list
+// until it is stopped (the list is still empty here)
+static void late_tick_test(void)
+{
+  mss_timer_t hdl = mss_timer_create(IRQ_TASK_ID);
+  mss_timer_state_t state;
+
+  mss_timer_periodic_start(hdl, 5, 5);
+  mss_timer_tick_cnt += 5 * 6;
+  mss_timer_tick();
+
+  state = mss_timer_get_state(hdl);
+  if(state != MSS_TIMER_STATE_OVERFLOW)
+  {
+    printf("ERROR: late tick, timer state %02x\n", (unsigned)state);
+    errors++;
+  }
+
+  mss_timer_stop(hdl);
+  if(mss_timer_get_next_tick() != MSS_SLEEP_NO_TIMEOUT)
+  {
+    printf("ERROR: late tick, stopped timer still in the list\n");
+    errors++;
+  }
+}
+
+//*****************************************************************************
+// Tasks and scripted interrupts
+//*****************************************************************************
+
+static void timer_task(void* param)
+{
+  uint32_t i;
+
+  for(i=(uint32_t)(uintptr_t)param ; i<num_of_timers ;
+      i+=NUM_OF_TIMER_TASKS)
+  {
+    check_timer(&timers[i], i);
+  }
+}
+
+static void irq_task(void* param)
+{
+  (void)param;
+
+  if(rx_pending)
+  {
+    rx_pending = false;
+
+    // tasks do not consume virtual time
+    if(rx_time != mss_hal_sim_get_time())
+    {
+      error("late interrupt task", 0, rx_time);
+    }
+    add_checksum(rx_byte);
+  }
+
+  check_timer(&irq_timer, num_of_timers);
+}
+
+static void rx_byte_isr(uint16_t arg)
+{
+  MSS_LATENCY_ISR_ENTRY(LATENCY_SRC_RX_BYTE, IRQ_TASK_ID);
+
+  if(rx_pending)
+  {
+    error("interrupt overrun", 0, rx_time);
+  }
+
+  rx_byte = arg;
+  rx_time = mss_hal_sim_get_time();
+  rx_pending = true;
+  irqs++;
+  rx_irqs++;
+
+  mss_activate_task(IRQ_TASK_ID);
+  MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_UART);
+}
+
+static void start_timer_isr(uint16_t arg)
+{
+  irqs++;
+
+  if(mss_timer_start(irq_timer.hdl, (mss_timer_tick_t)arg))
+  {
+    irq_timer.expected = mss_hal_sim_get_time() + arg;
+  }
+}
+
+#if (MSS_POWER_STATS == TRUE)
+// the tasks take no virtual time, so the main run sleeps all the time; the
+// power statistics shall count every wake-up once with its source
+static void power_test(uint64_t end_time)
+{
+  mss_power_stats_t stats;
+  uint16_t src_cnt = 0;
+  uint8_t i;
+
+  mss_get_power_stats(&stats);
+  for(i=0 ; i<MSS_NUM_OF_WAKE_SRC ; i++)
+  {
+    src_cnt += stats.wake_src_cnt[i];
+  }
+
+  if((stats.active_ticks != 0) || (stats.sleep_ticks[0] != end_time) ||
+     (stats.wake_cnt != (uint16_t)mss_hal_sim_get_wakeups()) ||
+     (src_cnt != stats.wake_cnt) ||
+     (stats.wake_src_cnt[MSS_WAKE_SRC_UART] == 0))
+  {
+    printf("ERROR: power stats, %lu active, %lu sleep ticks, %u wake-ups, "
+           "%u by source\n", (unsigned long)stats.active_ticks,
+           (unsigned long)stats.sleep_ticks[0], (unsigned)stats.wake_cnt,
+           (unsigned)src_cnt);
+    errors++;
+  }
+  sleep_ticks = stats.sleep_ticks[0];
+}
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+//*****************************************************************************
+// Scheduler scenarios
+//*****************************************************************************
+
+#if defined(SIM_SCENARIOS)
+static void scenario_isr(uint16_t arg)
+{
+  scenario_step(arg);
+  MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_OTHER);
+}
+
+// run one step of a scenario from an interrupt at the current virtual time,
+// until nothing is left to do or the virtual time reaches the end
+static void scenario_run(void (*step)(uint16_t), uint16_t arg,
+                         mss_timer_tick_t ticks)
+{
+  uint64_t now = mss_hal_sim_get_time();
+
+  scenario_step = step;
+  mss_hal_sim_inject(now, IRQ_SCENARIO, arg);
+  mss_hal_sim_run(now + ticks);
+}
+
+// stop the timers and delete the tasks of the main run
+static void scenario_reset(void)
+{
+  uint32_t i;
+
+  for(i=0 ; i<num_of_timers ; i++)
+  {
+    mss_timer_stop(timers[i].hdl);
+  }
+  mss_timer_stop(irq_timer.hdl);
+
+  for(i=0 ; i<MSS_NUM_OF_TASKS ; i++)
+  {
+    mss_task_delete((uint8_t)i);
+  }
+}
+#endif /* defined(SIM_SCENARIOS) */
+
+#if defined(SIM_SCENARIOS) && (MSS_TRACE == TRUE)
+// read position after the newest trace record
+static uint16_t trace_skip(void)
+{
+  uint16_t pos = mss_trace_get_pos();
+  mss_trace_rec_t rec;
+
+  while(mss_trace_read(&pos, &rec))
+  {
+  }
+
+  return pos;
+}
+
+// the tasks traced as started from pos on shall be those of the log
+static void trace_check(const char* what, uint16_t pos, const uint8_t* log,
+                        uint16_t len)
+{
+  mss_trace_rec_t rec;
+  uint16_t starts = 0;
+  bool match = true;
+
+  while(mss_trace_read(&pos, &rec))
+  {
+    if(rec.event == MSS_TRACE_EV_START)
+    {
+      if((starts >= len) || (rec.task_id != log[starts]))
+      {
+        match = false;
+      }
+      starts++;
+    }
+  }
+
+  if(!match || (starts != len))
+  {
+    printf("ERROR: %s, %u traced starts, %u runs\n", what,
+           (unsigned)starts, (unsigned)len);
+    errors++;
+  }
+}
+#endif /* defined(SIM_SCENARIOS) && (MSS_TRACE == TRUE) */
+
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+static void rr_task(void* param)
+{
+  uint8_t id = (uint8_t)(uintptr_t)param;
+
+  if(rr_log_len < RR_LOG_LEN)
+  {
+    rr_log[rr_log_len++] = id;
+  }
+
+  if((id < MSS_TASKS_PER_PRIO_LEVEL) && (++rr_runs[id] < RR_ROUNDS))
+  {
+    // ready again before the scheduler picks the next task
+    mss_activate_task(id);
+  }
+}
+
+static void rr_step(uint16_t step)
+{
+  uint8_t i;
+
+  (void)step;
+
+  for(i=0 ; i<=RR_LOW_TASK_ID ; i++)
+  {
+    mss_task_create(i, rr_task, (void*)(uintptr_t)i);
+  }
+}
+
+// the ready tasks of a level take turns, the next level runs after all of
+// them; the first turn may start anywhere in the level
+static void rr_test(void)
+{
+  uint16_t i;
+#if (MSS_TASK_STATS == TRUE)
+  mss_task_stats_t stats;
+  uint16_t rounds;
+#endif
+#if (MSS_TRACE == TRUE)
+  uint16_t pos;
+#endif
+
+#if (MSS_TRACE == TRUE)
+  pos = trace_skip();
+#endif
+  scenario_run(rr_step, 0, 100);
+#if (MSS_TRACE == TRUE)
+  trace_check("round-robin trace", pos, rr_log, rr_log_len);
+#endif
+
+  for(i=0 ; i<RR_LOG_LEN-1 ; i++)
+  {
+    if(rr_log[i] != ((rr_log[0] + i) % MSS_TASKS_PER_PRIO_LEVEL))
+    {
+      break;
+    }
+  }
+
+  if((rr_log_len != RR_LOG_LEN) || (i != RR_LOG_LEN-1) ||
+     (rr_log[RR_LOG_LEN-1] != RR_LOW_TASK_ID))
+  {
+    printf("ERROR: round-robin, %u runs, run %u out of turn\n",
+           (unsigned)rr_log_len, (unsigned)i);
+    errors++;
+  }
+
+#if (MSS_TASK_STATS == TRUE)
+  // a task which activates itself while it runs is reactivated
+  for(i=0 ; i<=RR_LOW_TASK_ID ; i++)
+  {
+    mss_task_get_stats((uint8_t)i, &stats);
+    rounds = (i < MSS_TASKS_PER_PRIO_LEVEL) ? RR_ROUNDS : 1;
+    if((stats.runs != rounds) || (stats.activations != 1) ||
+       (stats.reactivations != rounds - 1))
+    {
+      printf("ERROR: round-robin, task %u stats %u runs, %u activations, "
+             "%u reactivations\n", (unsigned)i, (unsigned)stats.runs,
+             (unsigned)stats.activations, (unsigned)stats.reactivations);
+      errors++;
+    }
+  }
+#endif /* (MSS_TASK_STATS == TRUE) */
+
+  for(i=0 ; i<=RR_LOW_TASK_ID ; i++)
+  {
+    mss_task_delete((uint8_t)i);
+  }
+}
+#endif /* (MSS_TASKS_PER_PRIO_LEVEL > 1) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+static void edf_task(void* param)
+{
+  uint8_t id = (uint8_t)(uintptr_t)param;
+
+  if(edf_log_len < EDF_NUM_OF_TASKS)
+  {
+    edf_log[edf_log_len++] = id;
+  }
+
+  if(edf_poll && (id == EDF_POLL_TASK_ID))
+  {
+    // busy past the deadline, the expired timer reactivates the task
+    edf_poll = false;
+    mss_timer_start(MSS_TASK_TIMER, EDF_POLL_TICKS);
+    while(!mss_timer_check_expired(MSS_TASK_TIMER))
+    {
+      mss_hal_sim_poll();
+    }
+  }
+}
+
+static void edf_step(uint16_t step)
+{
+  uint8_t i;
+
+  switch(step)
+  {
+  case 0:
+    // the deadlines at the activation are those of the first jobs, the
+    // new ones apply from the next activation on
+    mss_task_set_deadline(0, 40);
+    mss_task_set_deadline(1, 10);
+    mss_task_set_deadline(2, 30);
+    for(i=0 ; i<EDF_NUM_OF_TASKS ; i++)
+    {
+      mss_task_create(i, edf_task, (void*)(uintptr_t)i);
+    }
+    mss_task_set_deadline(1, MSS_EDF_NO_DEADLINE);
+    mss_task_set_deadline(3, 5);
+    break;
+
+  case 1:
+    for(i=0 ; i<EDF_NUM_OF_TASKS ; i++)
+    {
+      mss_activate_task(i);
+    }
+    break;
+
+  default:
+    edf_poll = true;
+    mss_activate_task(EDF_POLL_TASK_ID);
+    break;
+  }
+}
+
+// run the EDF steps, the tasks shall run in the expected order
+static void edf_check(uint16_t step, const uint8_t* order)
+{
+  uint16_t i;
+#if (MSS_TRACE == TRUE)
+  uint16_t pos;
+
+  pos = trace_skip();
+#endif
+
+  edf_log_len = 0;
+  scenario_run(edf_step, step, 100);
+#if (MSS_TRACE == TRUE)
+  trace_check("EDF trace", pos, edf_log, edf_log_len);
+#endif
+
+  for(i=0 ; i<EDF_NUM_OF_TASKS ; i++)
+  {
+    if((i >= edf_log_len) || (edf_log[i] != order[i]))
+    {
+      printf("ERROR: EDF step %u, run %u out of order\n", (unsigned)step,
+             (unsigned)i);
+      errors++;
+      break;
+    }
+  }
+}
+
+static void edf_test(void)
+{
+  static const uint8_t first_jobs[EDF_NUM_OF_TASKS] = { 1, 2, 0, 3 };
+  static const uint8_t next_jobs[EDF_NUM_OF_TASKS] = { 3, 2, 0, 1 };
+  uint8_t i;
+#if (MSS_POWER_STATS == TRUE)
+  mss_power_stats_t power;
+#endif
+
+  edf_check(0, first_jobs);
+  edf_check(1, next_jobs);
+
+  // only the job which polled past its deadline is a miss
+#if (MSS_POWER_STATS == TRUE)
+  mss_reset_power_stats();
+#endif
+  edf_log_len = 0;
+  scenario_run(edf_step, 2, 100);
+#if (MSS_POWER_STATS == TRUE)
+  // the polling task keeps the CPU active
+  mss_get_power_stats(&power);
+  if(power.active_ticks != EDF_POLL_TICKS)
+  {
+    printf("ERROR: EDF, %lu active ticks while polling\n",
+           (unsigned long)power.active_ticks);
+    errors++;
+  }
+#endif
+  for(i=0 ; i<EDF_NUM_OF_TASKS ; i++)
+  {
+    edf_misses += mss_task_get_deadline_misses(i);
+  }
+  if((edf_log_len != 2) || (edf_misses != 1) ||
+     (mss_task_get_deadline_misses(EDF_POLL_TASK_ID) != 1))
+  {
+    printf("ERROR: EDF, %u runs, %u deadline misses\n",
+           (unsigned)edf_log_len, (unsigned)edf_misses);
+    errors++;
+  }
+
+  for(i=0 ; i<EDF_NUM_OF_TASKS ; i++)
+  {
+    mss_task_delete(i);
+  }
+}
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
+//*****************************************************************************
+// Main
+//*****************************************************************************
+
+int main(int argc, char* argv[])
+{
+  unsigned long hours = DEFAULT_HOURS;
+  const char* script = DEFAULT_SCRIPT;
+  int32_t num_of_irqs;
+  uint64_t start, ns, end_time;
+  unsigned long events;
+  uint32_t wakeups;
+#if (MSS_LATENCY_STATS == TRUE)
+  mss_latency_stats_t latency;
+#endif
+  uint32_t i;
+
+  num_of_timers = DEFAULT_NUM_OF_TIMERS;
+  if(argc > 1)
+  {
+    hours = strtoul(argv[1], NULL, 0);
+  }
+  if(argc > 2)
+  {
+    num_of_timers = strtoul(argv[2], NULL, 0);
+  }
+  if(argc > 3)
+  {
+    script = argv[3];
+  }
+
+  if(num_of_timers + 2 > MSS_MAX_NUM_OF_TIMER - NUM_OF_TASK_TIMERS)
+  {
+    printf("at most %d timers\n",
+           MSS_MAX_NUM_OF_TIMER - NUM_OF_TASK_TIMERS - 2);
+    return 2;
+  }
+
+  mss_init();
+
+  late_tick_test();
+
+  mss_hal_sim_set_isr(IRQ_RX_BYTE, rx_byte_isr);
+  mss_hal_sim_set_isr(IRQ_START_TIMER, start_timer_isr);
+#if defined(SIM_SCENARIOS)
+  mss_hal_sim_set_isr(IRQ_SCENARIO, scenario_isr);
+#endif
+  num_of_irqs = mss_hal_sim_load_script(script);
+  if(num_of_irqs < 0)
+  {
+    printf("can not load %s\n", script);
+    return 2;
+  }
+
+  for(i=0 ; i<NUM_OF_TIMER_TASKS ; i++)
+  {
+    mss_task_create(i, timer_task, (void*)(uintptr_t)i);
+  }
+  mss_task_create(IRQ_TASK_ID, irq_task, NULL);
+
+  // the tick counter starts just below MSB_TMR_MASK, so the timers are
+  // sorted across the half boundary right from the start
+  mss_timer_tick_cnt = (mss_timer_tick_t)(MSB_TICK - 16);
+
+  timers = calloc(num_of_timers, sizeof(sim_timer_t));
+  for(i=0 ; i<num_of_timers ; i++)
+  {
+    timers[i].hdl = mss_timer_create(i % NUM_OF_TIMER_TASKS);
+    timers[i].expected = random_period();
+    if(i & 1)
+    {
+      timers[i].reload = random_period();
+      mss_timer_periodic_start(timers[i].hdl,
+                               (mss_timer_tick_t)timers[i].expected,
+                               timers[i].reload);
+    }
+    else
+    {
+      mss_timer_start(timers[i].hdl, (mss_timer_tick_t)timers[i].expected);
+    }
+  }
+  irq_timer.hdl = mss_timer_create(IRQ_TASK_ID);
+
+  start = now_ns();
+  end_time = mss_hal_sim_run((uint64_t)hours * TICKS_PER_HOUR);
+  ns = now_ns() - start;
+  wakeups = mss_hal_sim_get_wakeups();
+
+  // final check of the timers which shall have expired by now
+  for(i=0 ; i<num_of_timers ; i++)
+  {
+    check_timer(&timers[i], i);
+  }
+
+  if(irqs > (unsigned long)num_of_irqs)
+  {
+    printf("ERROR: %lu interrupts served, %ld scripted\n", irqs,
+           (long)num_of_irqs);
+    errors++;
+  }
+
+#if (MSS_POWER_STATS == TRUE)
+  power_test(end_time);
+#endif
+
+#if (MSS_LATENCY_STATS == TRUE)
+  // every received byte starts the interrupt task once
+  mss_latency_get_stats(LATENCY_SRC_RX_BYTE, &latency);
+  if(latency.cnt != rx_irqs)
+  {
+    printf("ERROR: %u latencies measured, %lu bytes received\n",
+           (unsigned)latency.cnt, rx_irqs);
+    errors++;
+  }
+#endif
+
+#if defined(SIM_SCENARIOS)
+  // the scheduler scenarios of the configuration, after the main run
+  scenario_reset();
+#endif
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+  rr_test();
+#endif
+#if (MSS_EDF_SCHEDULING == TRUE)
+  edf_test();
+#endif
+
+  events = expirations + irqs;
+  printf("virtual time             %llu ticks (%.2f h)\n",
+         (unsigned long long)end_time,
+         (double)end_time / (double)TICKS_PER_HOUR);
+  printf("timers                   %lu\n", (unsigned long)num_of_timers);
+  printf("timer expirations        %lu\n", expirations);
+  printf("scripted interrupts      %lu of %ld\n", irqs, (long)num_of_irqs);
+  printf("wake-ups                 %lu\n", (unsigned long)wakeups);
+#if (MSS_POWER_STATS == TRUE)
+  printf("sleep ticks              %lu\n", (unsigned long)sleep_ticks);
+#endif
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+  printf("round-robin runs         %u\n", (unsigned)rr_log_len);
+#endif
+#if (MSS_EDF_SCHEDULING == TRUE)
+  printf("EDF deadline misses      %u\n", (unsigned)edf_misses);
+#endif
+  printf("host time                %.3f ms\n", (double)ns / 1e6);
+  printf("cost per event           %.1f ns\n",
+         events ? ((double)ns / (double)events) : 0.0);
+  printf("checksum                 %08lx\n", (unsigned long)checksum);
+  printf("errors                   %lu\n", errors);
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS, UART, Flash & Audit module headers. //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "UART.h"
+#include "Flash.h"
+#include "Audit.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Audit Module function prototypes.        //
+////////////////////////////////////////////////////////////////////
+void AuditInit(void);
+void AuditLog(INT8U event, INT16U key_id);
+void AuditFlush(void);
+void AuditExport(void);
+static void AuditPut(INT8U event, INT16U key_id, INT16U tick);
+static void AuditSend(INT8U ring);
+static INT8U AuditRead(INT16U rec, AUDIT_REC *out);
+
+////////////////////////////////////////////////////////////////////
+// MODULE VARIABLES - Audit Module Variables.                     //
+////////////////////////////////////////////////////////////////////
+
+static INT16U Next[2];                  // next record to program, per ring
+static INT16U Seq;                      // sequence number of next record
+static INT8U Len;                       // buffered records
+static AUDIT_REC Buf[AUDIT_BUF_RECORDS];
+static INT16U Denied;                   // denied commands not logged yet
+static INT16U DeniedTick;               // tick of the last denied record
+
+// Rings: the event ring, then the ring of denied commands
+#define RING_EVENT              (0)
+#define RING_DENIED             (1)
+#define RING(event)             ((event) == AUDIT_DENIED ? RING_DENIED \
+                                                         : RING_EVENT)
+#define RING_FIRST(ring)        ((ring) == RING_EVENT ? 0 : AUDIT_EVENT_RECORDS)
+#define RING_END(ring)          ((ring) == RING_EVENT ? AUDIT_EVENT_RECORDS \
+                                                      : AUDIT_RECORDS)
+
+// Flash address of a record
+#define REC_ADDR(rec)           (FLASH_AUDIT + ((rec) * AUDIT_REC_SIZE))
+
+// Event and check byte of a valid record
+#define REC_VALID(r)            (((r)->Event ^ (r)->Check) == 0xFF)
+
+////////////////////////////////////////////////////////////////////
+// AuditInit  - Finds the newest record of each ring (highest     //
+//              sequence number) and continues behind it. Slots   //
+//              left programmed by a power loss are skipped up to //
+//              the next segment, which is erased before use      //
+//              anyway.                                           //
+// Parameters - None                                              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void AuditInit(void)
+{
+    AUDIT_REC rec;
+    INT16U i, seq, addr;
+    INT8U ring, found, any = FALSE;
+
+    Seq = 0;
+    Len = 0;
+    Denied = 0;
+    DeniedTick = (INT16U)mss_timer_get_tick_cnt() - AUDIT_DENIED_MS;
+
+    for (ring = RING_EVENT; ring <= RING_DENIED; ring++) {
+        Next[ring] = RING_FIRST(ring);
+        seq = 0;
+        found = FALSE;
+
+        for (i = RING_FIRST(ring); i < RING_END(ring); i++) {
+            if (AuditRead(i, &rec) == TRUE
+                && (found == FALSE || (INT16S)(rec.Seq - seq) >= 0)) {
+                Next[ring] = i + 1;
+                seq = rec.Seq;
+                found = TRUE;
+            }
+        }
+        if (found == TRUE && (any == FALSE || (INT16S)(seq + 1 - Seq) > 0)) {
+            Seq = seq + 1;
+            any = TRUE;
+        }
+
+        while ((Next[ring] % AUDIT_SEG_RECORDS) != 0) {
+            addr = REC_ADDR(Next[ring]);
+            if (FlashReadWord(addr) == FLASH_ERASED
+                && FlashReadWord(addr + 6) == FLASH_ERASED) {
+                break;
+            }
+            Next[ring]++;
+        }
+        if (Next[ring] >= RING_END(ring)) {
+            Next[ring] = RING_FIRST(ring);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// AuditLog   - Records an event in the RAM buffer, the buffer is //
+//              programmed once it is full. A denied command is   //
+//              only counted, unless AUDIT_DENIED_MS have passed  //
+//              since the last denied record.                     //
+// Parameters - INT8U event - AUDIT_xxx                           //
+//              INT16U key_id - Key id or event data              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void AuditLog(INT8U event, INT16U key_id)
+{
+    INT16U tick = (INT16U)mss_timer_get_tick_cnt();
+
+    if (event == AUDIT_DENIED) {
+        if (Denied < 0xFFFF) {
+            Denied++;
+        }
+        if ((INT16U)(tick - DeniedTick) < AUDIT_DENIED_MS) {
+            return;
+        }
+    } else if (Denied > 0) {
+        AuditPut(AUDIT_DENIED, 0, tick);
+    }
+    AuditPut(event, key_id, tick);
+}
+
+////////////////////////////////////////////////////////////////////
+// AuditFlush - Programs the buffered records into their rings,   //
+//              erasing the oldest segment of a ring when it      //
+//              wraps into it                                     //
+// Parameters - None                                              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void AuditFlush(void)
+{
+    const AUDIT_REC *rec;
+    INT16U addr;
+    INT8U i, ring;
+
+    for (i = 0; i < Len; i++) {
+        rec = &Buf[i];
+        ring = RING(rec->Event);
+        addr = REC_ADDR(Next[ring]);
+
+        if ((Next[ring] % AUDIT_SEG_RECORDS) == 0) {
+            FlashEraseSegment(addr);
+        }
+        FlashWriteWord(addr, rec->Seq);
+        FlashWriteWord(addr + 2, rec->Tick);
+        FlashWriteWord(addr + 4, rec->KeyId);
+        FlashWriteWord(addr + 6, rec->Event | ((INT16U)rec->Check << 8));
+
+        if (++Next[ring] >= RING_END(ring)) {
+            Next[ring] = RING_FIRST(ring);
+        }
+    }
+    Len = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+// AuditExport - Sends the whole log in one burst: 'M' 'A',       //
+//               AUDIT_REC_SIZE byte records as stored (seq,      //
+//               tick, key id, event, check; little endian), the  //
+//               event ring and then the ring of denied commands, //
+//               oldest record first, terminated by an erased     //
+//               record (all 0xFF), see tools/audit2csv.py        //
+// Parameters  - None                                             //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void AuditExport(void)
+{
+    INT8U n;
+
+    if (Denied > 0) {
+        AuditPut(AUDIT_DENIED, 0, (INT16U)mss_timer_get_tick_cnt());
+    }
+    AuditFlush();
+
+    UARTPutChar('M');
+    UARTPutChar('A');
+
+    AuditSend(RING_EVENT);
+    AuditSend(RING_DENIED);
+
+    for (n = 0; n < AUDIT_REC_SIZE; n++) {
+        UARTPutChar(0xFF);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// AuditPut   - Appends a record to the RAM buffer, a denied      //
+//              record takes the count of denied commands         //
+// Parameters - INT8U event - AUDIT_xxx                           //
+//              INT16U key_id - Key id or event data              //
+//              INT16U tick - MSS timer tick                      //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+static void AuditPut(INT8U event, INT16U key_id, INT16U tick)
+{
+    AUDIT_REC *rec = &Buf[Len];
+
+    if (event == AUDIT_DENIED) {
+        key_id = Denied;
+        Denied = 0;
+        DeniedTick = tick;
+    }
+
+    rec->Seq = Seq++;
+    rec->Tick = tick;
+    rec->KeyId = key_id;
+    rec->Event = event;
+    rec->Check = (INT8U)~event;
+
+    if (++Len >= AUDIT_BUF_RECORDS) {
+        AuditFlush();
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// AuditSend  - Sends the valid records of a ring, oldest first   //
+//              (the oldest record follows the newest one)        //
+// Parameters - INT8U ring - RING_EVENT or RING_DENIED            //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+static void AuditSend(INT8U ring)
+{
+    AUDIT_REC rec;
+    INT16U i, n;
+
+    i = Next[ring];
+    for (n = RING_FIRST(ring); n < RING_END(ring); n++) {
+        if (AuditRead(i, &rec) == TRUE) {
+            UARTPutChar((INT8U)rec.Seq);
+            UARTPutChar((INT8U)(rec.Seq >> 8));
+            UARTPutChar((INT8U)rec.Tick);
+            UARTPutChar((INT8U)(rec.Tick >> 8));
+            UARTPutChar((INT8U)rec.KeyId);
+            UARTPutChar((INT8U)(rec.KeyId >> 8));
+            UARTPutChar(rec.Event);
+            UARTPutChar(rec.Check);
+        }
+        if (++i >= RING_END(ring)) {
+            i = RING_FIRST(ring);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// AuditRead  - Reads a ring record                               //
+// Parameters - INT16U rec - Ring record index                    //
+//              AUDIT_REC *out - Record, set                      //
+// Return     - INT8U: TRUE if the record is valid                //
+////////////////////////////////////////////////////////////////////
+static INT8U AuditRead(INT16U rec, AUDIT_REC *out)
+{
+    INT16U addr = REC_ADDR(rec);
+    INT16U word = FlashReadWord(addr + 6);
+
+    out->Seq = FlashReadWord(addr);
+    out->Tick = FlashReadWord(addr + 2);
+    out->KeyId = FlashReadWord(addr + 4);
+    out->Event = (INT8U)word;
+    out->Check = (INT8U)(word >> 8);
+
+    return REC_VALID(out) ? TRUE : FALSE;
+}
@@ -0,0 +1,47 @@
+// Forward Facing Audit Log Functions
+extern void AuditInit(void);
+extern void AuditLog(INT8U event, INT16U key_id);
+extern void AuditFlush(void);
+extern void AuditExport(void);
+
+// Audit log: two rings of fixed size records in the AUDIT flash region,
+// the event ring (lock, unlock, enroll, revoke, ...) and the ring of
+// denied commands, so that denied commands never evict other events. A
+// ring is written in order, a segment is erased when the ring wraps into
+// it (the oldest AUDIT_SEG_RECORDS records of the ring). Records are
+// collected in a RAM buffer and programmed AUDIT_BUF_RECORDS at a time.
+//
+// Denied commands are counted in RAM and logged as one record at most
+// every AUDIT_DENIED_MS, so a flood of bad frames costs a segment erase
+// (about 20 ms with the interrupts off) only every AUDIT_SEG_RECORDS
+// such periods. The count is also logged before any other event and by
+// AuditExport.
+//
+// Record (little endian words): sequence number, which goes on across
+// reboots and orders the ring, MSS timer tick (ms, 16 bit), key id,
+// event and its complement (an erased record or one cut short by a power
+// loss is no valid record).
+typedef struct {
+    INT16U Seq;
+    INT16U Tick;
+    INT16U KeyId;
+    INT8U Event;
+    INT8U Check;
+} AUDIT_REC;
+
+#define AUDIT_REC_SIZE          (8)
+#define AUDIT_RECORDS           (FLASH_AUDIT_SIZE / AUDIT_REC_SIZE)
+#define AUDIT_SEG_RECORDS       (FLASH_MAIN_SEG_SIZE / AUDIT_REC_SIZE)
+#define AUDIT_DENIED_RECORDS    (2 * AUDIT_SEG_RECORDS)     // last segments
+#define AUDIT_EVENT_RECORDS     (AUDIT_RECORDS - AUDIT_DENIED_RECORDS)
+#define AUDIT_BUF_RECORDS       (4)
+#define AUDIT_DENIED_MS         (30000)   // below the 16 bit tick range
+
+// Events, the opcodes of the commands
+#define AUDIT_BOOT              ('b')     // key id: restored lock state
+#define AUDIT_LOCK              (LOCK_CMD_CH)
+#define AUDIT_UNLOCK            (UNLOCK_CMD_CH)
+#define AUDIT_MANUAL            ('m')     // key id: new lock state
+#define AUDIT_DENIED            (DENIED_CH)      // key id: count
+#define AUDIT_ENROLL            (ENROLL_CMD_CH)  // key id: enrolled id
+#define AUDIT_REVOKE            (REVOKE_CMD_CH)  // key id: revoked id
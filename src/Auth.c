@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS & Authentication module headers.     //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "Auth.h"
+#include "Cred.h"
+#include "Flash.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Authentication Module prototypes.        //
+////////////////////////////////////////////////////////////////////
+void AuthInit(void);
+void AuthGetNonce(INT8U *nonce);
+INT8U AuthCheck(INT8U op, const INT8U *arg, INT8U arg_len,
+                const INT8U *cred);
+void AuthMac(const uint32_t *key, const INT8U *msg, INT8U len, INT8U *tag);
+void AuthCrypt(const uint32_t *key, const INT8U *nonce, INT8U *data);
+void AuthUnwrapKey(const INT8U *wrapped, uint32_t *key);
+static void AuthChaskey(const uint32_t *key, const INT8U *msg, INT8U len,
+                        uint32_t *v);
+static void AuthTimesTwo(uint32_t *l);
+static uint32_t AuthEpoch(void);
+static uint32_t AuthSeed(void);
+#if !defined(MSS_HAL_SIM) && !defined(MSS_HAL_POSIX)
+static bool AuthCapture(void);
+#endif
+
+////////////////////////////////////////////////////////////////////
+// MODULE VARIABLES - Authentication Module Variables.            //
+////////////////////////////////////////////////////////////////////
+
+// 32 bit words with byte access, little endian (MSP430 and host).
+// uint32_t rather than INT32U, which is 64 bit wide on the host.
+typedef union {
+    uint32_t w[AUTH_KEY_WORDS];
+    INT8U b[AUTH_KEY_WORDS * 4];
+} AUTH_BLOCK;
+
+// Nonce: the boot epoch and a counter, which starts at a random seed
+static union {
+    uint32_t w[2];
+    INT8U b[AUTH_NONCE_LEN];
+} Nonce;
+
+// Chaskey permutation: rotations by 16 are word swaps on the MSP430
+#define ROTL(x, b)  (((x) << (b)) | ((x) >> (32 - (b))))
+// Boot epoch in the EPOCH region: two segments used in turn, the header
+// word of the active one is the newer generation. Every boot programs
+// the next slot of the active segment to 0, the epoch is the generation
+// and the number of programmed slots. Once the segment is full the other
+// one is erased and gets the next generation, one erase per 255 boots.
+#define EPOCH_SEG_0             (FLASH_EPOCH)
+#define EPOCH_SEG_1             (FLASH_EPOCH + FLASH_MAIN_SEG_SIZE)
+#define EPOCH_SLOTS             ((FLASH_MAIN_SEG_SIZE / 2) - 1)
+#define EPOCH_SLOT(seg, slot)   ((seg) + 2 + ((slot) << 1))
+
+#define PERMUTE(v)                                                  \
+    do { INT8U r_;                                                  \
+         for (r_ = 0; r_ < AUTH_ROUNDS; r_++) {                     \
+             v[0] += v[1]; v[1] = ROTL(v[1], 5);  v[1] ^= v[0];     \
+             v[0] = ROTL(v[0], 16);                                 \
+             v[2] += v[3]; v[3] = ROTL(v[3], 8);  v[3] ^= v[2];     \
+             v[0] += v[3]; v[3] = ROTL(v[3], 13); v[3] ^= v[0];     \
+             v[2] += v[1]; v[1] = ROTL(v[1], 7);  v[1] ^= v[2];     \
+             v[2] = ROTL(v[2], 16);                                 \
+         } } while (0)
+
+////////////////////////////////////////////////////////////////////
+// AuthInit   - Starts the nonces of this boot: counts the boot   //
+//              epoch up and draws the seed of the nonce counter  //
+// Parameters - None                                              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void AuthInit(void)
+{
+    Nonce.w[0] = AuthEpoch();
+    Nonce.w[1] = AuthSeed();
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthGetNonce - Returns the nonce of the next command           //
+// Parameters   - INT8U *nonce - AUTH_NONCE_LEN bytes, set        //
+// Return       - None                                            //
+////////////////////////////////////////////////////////////////////
+void AuthGetNonce(INT8U *nonce)
+{
+    memcpy(nonce, Nonce.b, AUTH_NONCE_LEN);
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthCheck  - Checks the credentials of an authenticated        //
+//              command: one key lookup, one MAC and a constant   //
+//              time tag comparison, also for a key id which is   //
+//              not enrolled, so the time does not tell whether   //
+//              it is. Consumes the nonce, whether the            //
+//              credentials are good or not.                      //
+// Parameters - INT8U op - Command opcode                         //
+//              const INT8U *arg - Command arguments              //
+//              INT8U arg_len - Up to AUTH_ARG_MAX bytes          //
+//              const INT8U *cred - AUTH_CRED_LEN received bytes  //
+// Return     - INT8U: TRUE if the key is enrolled and the tag    //
+//              is valid                                          //
+////////////////////////////////////////////////////////////////////
+INT8U AuthCheck(INT8U op, const INT8U *arg, INT8U arg_len,
+                const INT8U *cred)
+{
+    INT8U msg[AUTH_NONCE_LEN + 1 + AUTH_ARG_MAX];
+    uint32_t key[AUTH_KEY_WORDS];
+    INT8U found;
+
+    found = CredLookup(CRED_ID(cred), key);
+
+    memcpy(msg, Nonce.b, AUTH_NONCE_LEN);
+    msg[AUTH_NONCE_LEN] = op;
+    memcpy(&msg[AUTH_NONCE_LEN + 1], arg, arg_len);
+    // The message is read before the tag is written, it takes its place
+    AuthMac(key, msg, AUTH_NONCE_LEN + 1 + arg_len, msg);
+    Nonce.w[1]++;
+
+    return CredEqual(msg, &cred[CRED_ID_LEN], AUTH_TAG_LEN) & found;
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthMac    - Chaskey-12 MAC of a message, 32 bit ARX suited to //
+//              the 16 bit MSP430 (SipHash needs 64 bit words)    //
+// Parameters - const uint32_t *key - AUTH_KEY_WORDS key words    //
+//              const INT8U *msg - Message                        //
+//              INT8U len - Message length in bytes               //
+//              INT8U *tag - AUTH_TAG_LEN bytes, set              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void AuthMac(const uint32_t *key, const INT8U *msg, INT8U len, INT8U *tag)
+{
+    AUTH_BLOCK v;
+
+    AuthChaskey(key, msg, len, v.w);
+    memcpy(tag, v.b, AUTH_TAG_LEN);
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthCrypt  - Encrypts or decrypts a key: XOR with the full     //
+//              Chaskey block of the nonce and the byte 0x00,     //
+//              which is no opcode, so the key stream is never    //
+//              the MAC of a command                              //
+// Parameters - const uint32_t *key - AUTH_KEY_WORDS key words    //
+//              const INT8U *nonce - AUTH_NONCE_LEN bytes         //
+//              INT8U *data - AUTH_KEY_LEN bytes, updated         //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void AuthCrypt(const uint32_t *key, const INT8U *nonce, INT8U *data)
+{
+    INT8U msg[AUTH_NONCE_LEN + 1];
+    AUTH_BLOCK v;
+    INT8U i;
+
+    memcpy(msg, nonce, AUTH_NONCE_LEN);
+    msg[AUTH_NONCE_LEN] = 0x00;
+    AuthChaskey(key, msg, sizeof(msg), v.w);
+    for (i = 0; i < AUTH_KEY_LEN; i++) {
+        data[i] ^= v.b[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthUnwrapKey - Decrypts the key of the enrollment checked     //
+//                 last (AuthCheck), under its nonce              //
+// Parameters    - const INT8U *wrapped - AUTH_KEY_LEN bytes      //
+//                 uint32_t *key - AUTH_KEY_WORDS words, set      //
+// Return        - None                                           //
+////////////////////////////////////////////////////////////////////
+void AuthUnwrapKey(const INT8U *wrapped, uint32_t *key)
+{
+    uint32_t admin[AUTH_KEY_WORDS];
+    uint32_t nonce[2];
+
+    CredLookup(CRED_ADMIN_ID, admin);
+    nonce[0] = Nonce.w[0];
+    nonce[1] = Nonce.w[1] - 1;
+    memcpy(key, wrapped, AUTH_KEY_LEN);
+    AuthCrypt(admin, (const INT8U *)nonce, (INT8U *)key);
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthChaskey - Chaskey-12 of a message, the full last block.    //
+//               The subkeys are derived on the fly, the state    //
+//               block of the caller and the subkey are the only  //
+//               blocks kept on the stack.                        //
+// Parameters  - const uint32_t *key - AUTH_KEY_WORDS key words   //
+//               const INT8U *msg - Message                       //
+//               INT8U len - Message length in bytes              //
+//               uint32_t *v - AUTH_KEY_WORDS words of state, set //
+//               to the result, bytes little endian as AUTH_BLOCK //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+static void AuthChaskey(const uint32_t *key, const INT8U *msg, INT8U len,
+                        uint32_t *v)
+{
+    INT8U *b = (INT8U *)v;
+    AUTH_BLOCK l;
+    INT8U i;
+
+    for (i = 0; i < AUTH_KEY_WORDS; i++) {
+        v[i] = key[i];
+        l.w[i] = key[i];
+    }
+
+    // All blocks but the last one
+    while (len > sizeof(l)) {
+        for (i = 0; i < sizeof(l); i++) {
+            b[i] ^= *msg++;
+        }
+        PERMUTE(v);
+        len -= sizeof(l);
+    }
+
+    // Last block: K1 if complete, else K2 and padded with 0x01
+    AuthTimesTwo(l.w);
+    for (i = 0; i < len; i++) {
+        b[i] ^= *msg++;
+    }
+    if (len < sizeof(l)) {
+        b[len] ^= 0x01;
+        AuthTimesTwo(l.w);
+    }
+
+    for (i = 0; i < AUTH_KEY_WORDS; i++) {
+        v[i] ^= l.w[i];
+    }
+    PERMUTE(v);
+    for (i = 0; i < AUTH_KEY_WORDS; i++) {
+        v[i] ^= l.w[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthTimesTwo - Multiplies a subkey by x in GF(2^128)           //
+// Parameters   - uint32_t *l - AUTH_KEY_WORDS words, updated     //
+// Return       - None                                            //
+////////////////////////////////////////////////////////////////////
+static void AuthTimesTwo(uint32_t *l)
+{
+    uint32_t carry = (l[3] & 0x80000000UL) ? 0x87 : 0x00;
+
+    l[3] = (l[3] << 1) | (l[2] >> 31);
+    l[2] = (l[2] << 1) | (l[1] >> 31);
+    l[1] = (l[1] << 1) | (l[0] >> 31);
+    l[0] = (l[0] << 1) ^ carry;
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthEpoch  - Counts the persisted boot epoch up. A slot cut    //
+//              short by a power loss reads as programmed and is  //
+//              skipped, so the epoch never goes back.            //
+// Parameters - None                                              //
+// Return     - uint32_t: Epoch of this boot, larger than the one //
+//              of every earlier boot                             //
+////////////////////////////////////////////////////////////////////
+static uint32_t AuthEpoch(void)
+{
+    INT16U gen0 = FlashReadWord(EPOCH_SEG_0);
+    INT16U gen1 = FlashReadWord(EPOCH_SEG_1);
+    INT16U seg, gen;
+    INT16U slot;
+
+    if (gen1 == FLASH_ERASED
+        || (gen0 != FLASH_ERASED && (INT16S)(gen0 - gen1) > 0)) {
+        seg = EPOCH_SEG_0;
+        gen = gen0;
+    } else {
+        seg = EPOCH_SEG_1;
+        gen = gen1;
+    }
+
+    // First boot
+    if (gen == FLASH_ERASED) {
+        FlashEraseSegment(EPOCH_SEG_0);
+        FlashWriteWord(EPOCH_SEG_0, 0);
+        seg = EPOCH_SEG_0;
+        gen = 0;
+    }
+
+    slot = 0;
+    while (slot < EPOCH_SLOTS
+           && FlashReadWord(EPOCH_SLOT(seg, slot)) != FLASH_ERASED) {
+        slot++;
+    }
+
+    // The header is written last, a cut erase leaves the old segment active
+    if (slot >= EPOCH_SLOTS) {
+        seg = (seg == EPOCH_SEG_0) ? EPOCH_SEG_1 : EPOCH_SEG_0;
+        FlashEraseSegment(seg);
+        FlashWriteWord(seg, ++gen);
+        slot = 0;
+    }
+
+    FlashWriteWord(EPOCH_SLOT(seg, slot), 0);
+    return ((uint32_t)gen << 8) | (slot + 1);
+}
+
+#if !defined(MSS_HAL_SIM) && !defined(MSS_HAL_POSIX)
+////////////////////////////////////////////////////////////////////
+// AuthSeed   - Collects a random nonce seed from the jitter of   //
+//              the VLO against the DCO: the LSB of 32 VLO        //
+//              periods captured by Timer0_A (about 3 ms). Runs   //
+//              after mss_init started the shared counter and     //
+//              borrows a channel before MotorInit takes the last //
+// Parameters - None                                              //
+// Return     - uint32_t: Seed                                    //
+////////////////////////////////////////////////////////////////////
+static uint32_t AuthSeed(void)
+{
+    uint32_t seed = 0;
+    INT16U last;
+    INT16U now;
+    INT8U ch;
+    INT8U i;
+
+    ch = mss_hal_timer_alloc(AuthCapture);
+    if (ch == MSS_HAL_TIMER_NONE) {
+        return 0;
+    }
+
+    last = mss_hal_timer_capture(ch);
+    for (i = 0; i < 32; i++) {
+        now = mss_hal_timer_capture(ch);
+        seed = (seed << 1) | ((now - last) & 0x01);
+        last = now;
+    }
+
+    mss_hal_timer_free(ch);
+    return seed;
+}
+
+////////////////////////////////////////////////////////////////////
+// AuthCapture - Handler of the borrowed channel, never called:   //
+//               the channel captures without interrupt           //
+// Parameters  - None                                             //
+// Return      - bool: false                                      //
+////////////////////////////////////////////////////////////////////
+static bool AuthCapture(void)
+{
+    return false;
+}
+#else
+////////////////////////////////////////////////////////////////////
+// AuthSeed   - Host simulation: a fixed seed, so that runs are   //
+//              reproducible                                      //
+// Parameters - None                                              //
+// Return     - uint32_t: Seed                                    //
+////////////////////////////////////////////////////////////////////
+static uint32_t AuthSeed(void)
+{
+    return 0;
+}
+#endif
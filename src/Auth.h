@@ -0,0 +1,29 @@
+// Forward Facing Authentication Functions
+extern void AuthInit(void);
+extern void AuthGetNonce(INT8U *nonce);
+extern INT8U AuthCheck(INT8U op, const INT8U *arg, INT8U arg_len,
+                       const INT8U *cred);
+extern void AuthMac(const uint32_t *key, const INT8U *msg, INT8U len,
+                    INT8U *tag);
+extern void AuthCrypt(const uint32_t *key, const INT8U *nonce, INT8U *data);
+extern void AuthUnwrapKey(const INT8U *wrapped, uint32_t *key);
+
+// Challenge-response: the lock hands out a nonce (CHALLENGE_CH), an
+// authenticated command carries its arguments, the id of an enrolled key
+// and the tag AuthMac(key, nonce | opcode | arguments), see Cred.h.
+// Every checked command consumes the nonce, the next one is the current
+// one with the counter (last 4 bytes, little endian) incremented. The
+// first 4 bytes are the boot epoch, which is persisted in flash and
+// grows on every boot, so a nonce never repeats across reboots either.
+// The counter starts at a random seed. An enrollment carries the new key
+// encrypted with the administrator key under the nonce of the command
+// (AuthCrypt), the tag covers the encrypted key.
+#define AUTH_KEY_WORDS      (4)
+#define AUTH_KEY_LEN        (AUTH_KEY_WORDS * 4)
+#define AUTH_NONCE_LEN      (8)
+#define AUTH_TAG_LEN        (8)
+#define AUTH_CRED_LEN       (2 + AUTH_TAG_LEN)     // key id, tag
+#define AUTH_ARG_MAX        (2 + AUTH_KEY_LEN)     // key id, key
+
+// Chaskey-12 rounds per block
+#define AUTH_ROUNDS         (12)
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS, Credential & Key Store headers.     //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "Auth.h"
+#include "Cred.h"
+#include "Flash.h"
+#include "KeyStore.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Credential Module function prototypes.   //
+////////////////////////////////////////////////////////////////////
+void CredInit(void);
+INT8U CredLookup(INT16U id, uint32_t *key);
+INT8U CredEnroll(INT16U id, const INT8U *wrapped);
+INT8U CredRevoke(INT16U id);
+INT8U CredEqual(const INT8U *a, const INT8U *b, INT8U len);
+static INT8U CredAdminKey(uint32_t *key);
+
+////////////////////////////////////////////////////////////////////
+// CredInit   - Loads the enrolled keys                           //
+// Parameters - None                                              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void CredInit(void)
+{
+    KeyStoreInit();
+}
+
+////////////////////////////////////////////////////////////////////
+// CredLookup - Finds an enrolled key by its id: the read of the  //
+//              administrator key, then a few key store probes    //
+//              whatever the number of keys. An id which is not   //
+//              enrolled gets the administrator key, so that both //
+//              take about the same time and the caller runs its  //
+//              MAC with a key, which is reported as not found.   //
+// Parameters - INT16U id - Key id                                //
+//              uint32_t *key - AUTH_KEY_WORDS words, set         //
+// Return     - INT8U: TRUE if enrolled                           //
+////////////////////////////////////////////////////////////////////
+INT8U CredLookup(INT16U id, uint32_t *key)
+{
+    INT8U found = CredAdminKey(key);
+
+    if (id != CRED_ADMIN_ID) {
+        found = KeyStoreFind(id, key);
+    }
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////
+// CredEnroll - Enrolls the key of a key id, received encrypted   //
+//              with the administrator key in the command checked //
+//              last (AuthUnwrapKey)                              //
+// Parameters - INT16U id - Key id                                //
+//              const INT8U *wrapped - AUTH_KEY_LEN bytes         //
+// Return     - INT8U: TRUE if enrolled, FALSE if the id is       //
+//              invalid or the key store is full                  //
+////////////////////////////////////////////////////////////////////
+INT8U CredEnroll(INT16U id, const INT8U *wrapped)
+{
+    uint32_t key[AUTH_KEY_WORDS];
+
+    if (id == CRED_ADMIN_ID) {
+        return FALSE;
+    }
+    AuthUnwrapKey(wrapped, key);
+    return KeyStoreAdd(id, key);
+}
+
+////////////////////////////////////////////////////////////////////
+// CredRevoke - Revokes a key id, the administrator id stays      //
+// Parameters - INT16U id - Key id                                //
+// Return     - INT8U: TRUE if revoked, FALSE if not enrolled     //
+////////////////////////////////////////////////////////////////////
+INT8U CredRevoke(INT16U id)
+{
+    if (id == CRED_ADMIN_ID) {
+        return FALSE;
+    }
+    return KeyStoreRemove(id);
+}
+
+////////////////////////////////////////////////////////////////////
+// CredEqual  - Compares two byte strings in constant time: every //
+//              byte is compared and the result is computed       //
+//              without a branch on the data                      //
+// Parameters - const INT8U *a, *b - Byte strings                 //
+//              INT8U len - Length in bytes                       //
+// Return     - INT8U: TRUE if equal                              //
+////////////////////////////////////////////////////////////////////
+INT8U CredEqual(const INT8U *a, const INT8U *b, INT8U len)
+{
+    INT8U diff = 0;
+
+    while (len > 0) {
+        diff |= *a++ ^ *b++;
+        len--;
+    }
+
+    // 0 - 1 borrows into the high byte, 1..255 - 1 does not
+    return (INT8U)((((INT16U)diff - 1) >> 8) & 0x01);
+}
+
+////////////////////////////////////////////////////////////////////
+// CredAdminKey - Reads the administrator key, which is written   //
+//                into information memory segment D when the      //
+//                device is programmed (tools/cred_provision.py)  //
+// Parameters   - uint32_t *key - AUTH_KEY_WORDS words, set       //
+// Return       - INT8U: TRUE if provisioned, FALSE if the        //
+//                segment is erased                               //
+////////////////////////////////////////////////////////////////////
+static INT8U CredAdminKey(uint32_t *key)
+{
+    INT16U erased = FLASH_ERASED;
+    INT16U lo, hi;
+    INT8U i;
+
+    for (i = 0; i < AUTH_KEY_WORDS; i++) {
+        lo = FlashReadWord(CRED_ADMIN_KEY + (i << 2));
+        hi = FlashReadWord(CRED_ADMIN_KEY + (i << 2) + 2);
+        key[i] = lo | ((uint32_t)hi << 16);
+        erased &= lo & hi;
+    }
+    return (erased != FLASH_ERASED) ? TRUE : FALSE;
+}
@@ -0,0 +1,19 @@
+// Forward Facing Credential Functions
+extern void CredInit(void);
+extern INT8U CredLookup(INT16U id, uint32_t *key);
+extern INT8U CredEnroll(INT16U id, const INT8U *wrapped);
+extern INT8U CredRevoke(INT16U id);
+extern INT8U CredEqual(const INT8U *a, const INT8U *b, INT8U len);
+
+// Key ids: an authenticated command names its key by the id (CRED_ID_LEN
+// bytes, little endian) in front of the tag. Every key is a secret of its
+// own: the administrator key is written into information memory segment
+// D with the firmware (tools/cred_provision.py), it is not in the source
+// and differs per device. It authenticates enrollment and revocation, an
+// enrollment carries the new key encrypted with it. The key store keeps
+// the ids and keys enrolled at run time (KeyStore.h). A device with an
+// erased segment D accepts no administrator command.
+#define CRED_ID_LEN         (2)
+#define CRED_ID(b)          ((b)[0] | ((INT16U)(b)[1] << 8))
+#define CRED_ADMIN_ID       (0x0001)
+#define CRED_ADMIN_KEY      (FLASH_INFO_D)
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS, Motor & Current module headers.     //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "Motor.h"
+#include "Current.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Current Module function prototypes.      //
+////////////////////////////////////////////////////////////////////
+void CurrentInit(void);
+void CurrentStart(void);
+void CurrentStop(void);
+INT16U CurrentPeak(void);
+
+////////////////////////////////////////////////////////////////////
+// MODULE VARIABLES - Current Module Variables.                   //
+////////////////////////////////////////////////////////////////////
+static INT16U Start;                    // MSS tick of the motor start
+static INT8U Over;                      // samples in a row over level
+static INT16U Peak;                     // highest sample after blanking
+
+////////////////////////////////////////////////////////////////////
+// CurrentInit - Sets up ADC10 for the shunt, sampling is started //
+//               with the motor                                   //
+// Parameters  - None                                             //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void CurrentInit(void)
+{
+    ADC10AE0 |= CURRENT_PIN;
+    ADC10CTL1 = CURRENT_INCH + ADC10SSEL_1 + CONSEQ_2;  // ACLK, repeat single channel
+    ADC10CTL0 = SREF_0 + ADC10SHT_3 + MSC + ADC10ON + ADC10IE;
+}
+
+////////////////////////////////////////////////////////////////////
+// CurrentStart - Starts sampling for a motor actuation           //
+// Parameters   - None                                            //
+// Return       - None                                            //
+////////////////////////////////////////////////////////////////////
+void CurrentStart(void)
+{
+    Start = (INT16U)mss_timer_get_tick_cnt();
+    Over = 0;
+    Peak = 0;
+    ADC10CTL0 |= ENC + ADC10SC;
+}
+
+////////////////////////////////////////////////////////////////////
+// CurrentStop - Stops sampling, at the end of the conversion     //
+// Parameters  - None                                             //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void CurrentStop(void)
+{
+    ADC10CTL0 &= ~(ENC + ADC10IFG);
+}
+
+////////////////////////////////////////////////////////////////////
+// CurrentPeak - Returns the peak current of the last actuation   //
+// Parameters  - None                                             //
+// Return      - INT16U: ADC10 counts, inrush excluded            //
+////////////////////////////////////////////////////////////////////
+INT16U CurrentPeak(void)
+{
+    return Peak;
+}
+
+////////////////////////////////////////////////////////////////////
+// ADC10      - Stall detection, cuts the motor as soon as the    //
+//              current stays at the stall level                  //
+// Parameters - None                                              //
+// Return     - __interrupt                                       //
+////////////////////////////////////////////////////////////////////
+#pragma vector=ADC10_VECTOR
+__interrupt void ADC10 (void)
+{
+    INT16U sample = ADC10MEM;
+
+    // Inrush and ramp: the motor starts with its stall current
+    if ((INT16U)((INT16U)mss_timer_get_tick_cnt() - Start)
+        < MSS_TIMER_MS_TO_TICKS(CURRENT_BLANK_MS)) {
+        return;
+    }
+    if (sample > Peak) {
+        Peak = sample;
+    }
+    if (sample < CURRENT_STALL_LEVEL) {
+        Over = 0;
+    } else if (++Over >= CURRENT_STALL_SAMPLES) {
+        MotorStop(TRUE);
+        MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_OTHER);
+    }
+}
@@ -0,0 +1,22 @@
+// Forward Facing Current Functions
+extern void CurrentInit(void);
+extern void CurrentStart(void);
+extern void CurrentStop(void);
+extern INT16U CurrentPeak(void);
+
+// Motor current sense: shunt in the H-bridge ground return on P1.4 (A4),
+// sampled by ADC10 in repeat single channel mode from ACLK (VLO 12 kHz).
+// A sample takes 64 + 13 ADC10CLK, about 6.4 ms. The shunt is 1 Ohm and
+// the reference is VCC (3 V), so a count is about 3 mA.
+#define CURRENT_PIN             BIT4
+#define CURRENT_INCH            INCH_4
+
+// Stall detection: the samples of the first CURRENT_BLANK_MS, timed by
+// the MSS tick of the shared Timer0_A, are the inrush and the soft start
+// ramp (Motor.h) and never stall. A number of samples would stretch and
+// shrink with the VLO (4 - 20 kHz). After that CURRENT_STALL_SAMPLES
+// samples in a row at or above CURRENT_STALL_LEVEL are a bolt at its end
+// stop.
+#define CURRENT_BLANK_MS        (MOTOR_RAMP_TIME + 20)
+#define CURRENT_STALL_LEVEL     90      // about 270 mA
+#define CURRENT_STALL_SAMPLES   3
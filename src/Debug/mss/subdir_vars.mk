@@ -6,61 +6,85 @@
 C_SRCS += \
 ../mss/llist.c \
 ../mss/mss.c \
+../mss/mss_barrier.c \
 ../mss/mss_event.c \
 ../mss/mss_hal.c \
+../mss/mss_latency.c \
 ../mss/mss_mem.c \
 ../mss/mss_mque.c \
+../mss/mss_rwlock.c \
 ../mss/mss_sema.c \
-../mss/mss_timer.c 
+../mss/mss_timer.c \
+../mss/mss_trace.c 
 
 OBJS += \
 ./mss/llist.obj \
 ./mss/mss.obj \
+./mss/mss_barrier.obj \
 ./mss/mss_event.obj \
 ./mss/mss_hal.obj \
+./mss/mss_latency.obj \
 ./mss/mss_mem.obj \
 ./mss/mss_mque.obj \
+./mss/mss_rwlock.obj \
 ./mss/mss_sema.obj \
-./mss/mss_timer.obj 
+./mss/mss_timer.obj \
+./mss/mss_trace.obj 
 
 C_DEPS += \
 ./mss/llist.pp \
 ./mss/mss.pp \
+./mss/mss_barrier.pp \
 ./mss/mss_event.pp \
 ./mss/mss_hal.pp \
+./mss/mss_latency.pp \
 ./mss/mss_mem.pp \
 ./mss/mss_mque.pp \
+./mss/mss_rwlock.pp \
 ./mss/mss_sema.pp \
-./mss/mss_timer.pp 
+./mss/mss_timer.pp \
+./mss/mss_trace.pp 
 
 C_DEPS__QUOTED += \
 "mss\llist.pp" \
 "mss\mss.pp" \
+"mss\mss_barrier.pp" \
 "mss\mss_event.pp" \
 "mss\mss_hal.pp" \
+"mss\mss_latency.pp" \
 "mss\mss_mem.pp" \
 "mss\mss_mque.pp" \
+"mss\mss_rwlock.pp" \
 "mss\mss_sema.pp" \
-"mss\mss_timer.pp" 
+"mss\mss_timer.pp" \
+"mss\mss_trace.pp" 
 
 OBJS__QUOTED += \
 "mss\llist.obj" \
 "mss\mss.obj" \
+"mss\mss_barrier.obj" \
 "mss\mss_event.obj" \
 "mss\mss_hal.obj" \
+"mss\mss_latency.obj" \
 "mss\mss_mem.obj" \
 "mss\mss_mque.obj" \
+"mss\mss_rwlock.obj" \
 "mss\mss_sema.obj" \
-"mss\mss_timer.obj" 
+"mss\mss_timer.obj" \
+"mss\mss_trace.obj" 
 
 C_SRCS__QUOTED += \
 "../mss/llist.c" \
 "../mss/mss.c" \
+"../mss/mss_barrier.c" \
 "../mss/mss_event.c" \
 "../mss/mss_hal.c" \
+"../mss/mss_latency.c" \
 "../mss/mss_mem.c" \
 "../mss/mss_mque.c" \
+"../mss/mss_rwlock.c" \
 "../mss/mss_sema.c" \
-"../mss/mss_timer.c" 
+"../mss/mss_timer.c" \
+"../mss/mss_trace.c" 
 
 
@@ -7,31 +7,79 @@ CMD_SRCS += \
 ../lnk_msp430g2553.cmd 
 
 C_SRCS += \
+../Current.c \
+../Audit.c \
+../Journal.c \
+../KeyStore.c \
+../Flash.c \
+../Cred.c \
+../Auth.c \
+../Frame.c \
 ../Motor.c \
 ../UART.c \
 ../main.c 
 
 OBJS += \
+./Current.obj \
+./Audit.obj \
+./Journal.obj \
+./KeyStore.obj \
+./Flash.obj \
+./Cred.obj \
+./Auth.obj \
+./Frame.obj \
 ./Motor.obj \
 ./UART.obj \
 ./main.obj 
 
 C_DEPS += \
+./Current.pp \
+./Audit.pp \
+./Journal.pp \
+./KeyStore.pp \
+./Flash.pp \
+./Cred.pp \
+./Auth.pp \
+./Frame.pp \
 ./Motor.pp \
 ./UART.pp \
 ./main.pp 
 
 C_DEPS__QUOTED += \
+"Current.pp" \
+"Audit.pp" \
+"Journal.pp" \
+"KeyStore.pp" \
+"Flash.pp" \
+"Cred.pp" \
+"Auth.pp" \
+"Frame.pp" \
 "Motor.pp" \
 "UART.pp" \
 "main.pp" 
 
 OBJS__QUOTED += \
+"Current.obj" \
+"Audit.obj" \
+"Journal.obj" \
+"KeyStore.obj" \
+"Flash.obj" \
+"Cred.obj" \
+"Auth.obj" \
+"Frame.obj" \
 "Motor.obj" \
 "UART.obj" \
 "main.obj" 
 
 C_SRCS__QUOTED += \
+"../Current.c" \
+"../Audit.c" \
+"../Journal.c" \
+"../KeyStore.c" \
+"../Flash.c" \
+"../Cred.c" \
+"../Auth.c" \
+"../Frame.c" \
 "../Motor.c" \
 "../UART.c" \
 "../main.c" 
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS & Flash module headers.              //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "Flash.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Flash Module function prototypes.        //
+////////////////////////////////////////////////////////////////////
+void FlashInit(void);
+INT16U FlashReadWord(INT16U addr);
+void FlashWriteWord(INT16U addr, INT16U value);
+void FlashEraseSegment(INT16U addr);
+
+#if !defined(MSS_HAL_SIM)
+
+////////////////////////////////////////////////////////////////////
+// FlashInit  - Sets the flash timing generator to SMCLK / 3      //
+//              (333 kHz, 257 - 476 kHz allowed) from the 1 MHz   //
+//              SMCLK of the calibrated DCO, so it runs after     //
+//              mss_init and before the first erase or write      //
+// Parameters - None                                              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void FlashInit(void)
+{
+    FCTL2 = FWKEY + FSSEL_2 + FN1;
+}
+
+////////////////////////////////////////////////////////////////////
+// FlashReadWord - Reads one word of flash                        //
+// Parameters    - INT16U addr - Word address                     //
+// Return        - INT16U: Word                                   //
+////////////////////////////////////////////////////////////////////
+INT16U FlashReadWord(INT16U addr)
+{
+    return *(const volatile INT16U *)addr;
+}
+
+////////////////////////////////////////////////////////////////////
+// FlashWriteWord - Programs one word, which only clears bits.    //
+//                  The CPU is held for about 75 us.              //
+// Parameters     - INT16U addr - Word address                    //
+//                  INT16U value - Word                           //
+// Return         - None                                          //
+////////////////////////////////////////////////////////////////////
+void FlashWriteWord(INT16U addr, INT16U value)
+{
+    mss_int_flag_t int_flag;
+
+    MSS_ENTER_CRITICAL_SECTION(int_flag);
+    FCTL3 = FWKEY;                            // Unlock, LOCKA unchanged
+    FCTL1 = FWKEY + WRT;
+    *(volatile INT16U *)addr = value;
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+    MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+////////////////////////////////////////////////////////////////////
+// FlashEraseSegment - Erases the segment of an address to 0xFF.  //
+//                     The CPU is held for about 20 ms.           //
+// Parameters        - INT16U addr - Address in the segment       //
+// Return            - None                                       //
+////////////////////////////////////////////////////////////////////
+void FlashEraseSegment(INT16U addr)
+{
+    mss_int_flag_t int_flag;
+
+    MSS_ENTER_CRITICAL_SECTION(int_flag);
+    FCTL3 = FWKEY;                            // Unlock, LOCKA unchanged
+    FCTL1 = FWKEY + ERASE;
+    *(volatile INT16U *)addr = 0;             // Dummy write starts erase
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+    MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////
+// Host simulation: the information memory and the main memory    //
+// data regions in RAM, stored inverted so that the zero          //
+// initialized arrays read as erased flash and keep their         //
+// contents across FlashInit (a reboot of the node).              //
+////////////////////////////////////////////////////////////////////
+static INT16U FlashSimInfo[FLASH_INFO_SIZE / 2];
+static INT16U FlashSimData[FLASH_DATA_SIZE / 2];
+#define FLASH_SIM_WORD(addr)                                        \
+    (*(((addr) >= FLASH_DATA)                                       \
+       ? &FlashSimData[((addr) - FLASH_DATA) / 2]                   \
+       : &FlashSimInfo[((addr) - FLASH_INFO_D) / 2]))
+
+void FlashInit(void)
+{
+}
+
+INT16U FlashReadWord(INT16U addr)
+{
+    return (INT16U)~FLASH_SIM_WORD(addr);
+}
+
+void FlashWriteWord(INT16U addr, INT16U value)
+{
+    FLASH_SIM_WORD(addr) |= (INT16U)~value;
+}
+
+void FlashEraseSegment(INT16U addr)
+{
+    INT16U size = (addr >= FLASH_DATA) ? FLASH_MAIN_SEG_SIZE
+                                        : FLASH_INFO_SEG_SIZE;
+
+    addr &= ~(size - 1);
+    memset(&FLASH_SIM_WORD(addr), 0, size);
+}
+
+#endif
@@ -0,0 +1,31 @@
+// Forward Facing Flash Functions
+extern void FlashInit(void);
+extern INT16U FlashReadWord(INT16U addr);
+extern void FlashWriteWord(INT16U addr, INT16U value);
+extern void FlashEraseSegment(INT16U addr);
+
+// Information memory segments (segment A holds the calibration data and
+// is never written)
+#define FLASH_INFO_D            (0x1000)
+#define FLASH_INFO_C            (0x1040)
+#define FLASH_INFO_B            (0x1080)
+#define FLASH_INFO_SIZE         (0x0100)
+#define FLASH_INFO_SEG_SIZE     (64)
+
+// Main memory regions of the enrolled keys (KEYS in lnk_msp430g2553.cmd),
+// of the boot epoch (EPOCH) and of the audit log (AUDIT), kept clear of
+// the segment of the interrupt vectors
+#define FLASH_KEYS              (0xEC00)
+#define FLASH_KEYS_SIZE         (0x0400)
+#define FLASH_EPOCH             (0xF000)
+#define FLASH_EPOCH_SIZE        (0x0400)
+#define FLASH_AUDIT             (0xF400)
+#define FLASH_AUDIT_SIZE        (0x0A00)
+#define FLASH_MAIN_SEG_SIZE     (512)
+
+// Main memory data regions, from the first one up to the vectors
+#define FLASH_DATA              (FLASH_KEYS)
+#define FLASH_DATA_SIZE         (FLASH_AUDIT + FLASH_AUDIT_SIZE - FLASH_DATA)
+
+// Value of an erased word, programming only clears bits
+#define FLASH_ERASED            (0xFFFF)
@@ -0,0 +1,20 @@
+// Forward Facing Frame Functions
+extern void FrameInit(void);
+extern INT8U FrameRxByte(INT8U byte);
+extern void FrameRxTimeout(void);
+extern INT8U FrameGet(INT8U **payload);
+extern void FrameRelease(void);
+extern void FrameSend(const INT8U *payload, INT8U len);
+extern INT16U FrameCrc16(INT16U crc, INT8U byte);
+
+// Frame format (both directions):
+//   SOF | LEN | PAYLOAD[LEN] | CRC MSB | CRC LSB
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial 0xFFFF) over LEN and
+// PAYLOAD. Sent MSB first, the CRC over LEN..CRC LSB of a good frame is 0.
+// A request payload is a sequence of commands (opcode + arguments, see
+// includes.h), the reply payload has one opcode + result pair per command
+// (the result of CHALLENGE_CH is the nonce), so a frame carries up to
+// FRAME_MAX_PAYLOAD / 2 commands.
+#define FRAME_SOF           (0x7E)
+#define FRAME_MAX_PAYLOAD   (32)
+#define FRAME_CRC_INIT      (0xFFFF)
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS, Motor, Flash & Journal headers.     //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "Motor.h"
+#include "Flash.h"
+#include "Journal.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Journal Module function prototypes.      //
+////////////////////////////////////////////////////////////////////
+void JournalInit(void);
+INT8U JournalState(void);
+void JournalWrite(INT8U state);
+
+////////////////////////////////////////////////////////////////////
+// MODULE VARIABLES - Journal Module Variables.                   //
+////////////////////////////////////////////////////////////////////
+
+static INT16U Seg;                      // active segment
+static INT16U Gen;                      // its generation
+static INT8U Next;                      // first free record
+static INT8U State;                     // last valid record, INIT if none
+
+// Address of a record, the header is the first word of the segment
+#define RECORD_ADDR(seg, rec)   ((seg) + 2 + ((rec) << 1))
+
+////////////////////////////////////////////////////////////////////
+// JournalInit - Finds the active segment (the newer              //
+//               generation, none on first boot) and replays it   //
+//               up to the first free record                      //
+// Parameters  - None                                             //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void JournalInit(void)
+{
+    INT16U gen0 = FlashReadWord(JOURNAL_SEG_0);
+    INT16U gen1 = FlashReadWord(JOURNAL_SEG_1);
+    INT16U word;
+
+    if (gen1 == FLASH_ERASED
+        || (gen0 != FLASH_ERASED && (INT16S)(gen0 - gen1) > 0)) {
+        Seg = JOURNAL_SEG_0;
+        Gen = gen0;
+    } else {
+        Seg = JOURNAL_SEG_1;
+        Gen = gen1;
+    }
+
+    State = INIT;
+    if (Gen == FLASH_ERASED) {
+        // First boot: the first record starts segment 0
+        Seg = JOURNAL_SEG_1;
+        Next = JOURNAL_RECORDS;
+        return;
+    }
+    for (Next = 0; Next < JOURNAL_RECORDS; Next++) {
+        word = FlashReadWord(RECORD_ADDR(Seg, Next));
+        if (word == FLASH_ERASED) {
+            break;
+        }
+        if (JOURNAL_VALID(word)) {
+            State = (INT8U)word;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// JournalState - Returns the journaled lock state                //
+// Parameters   - None                                            //
+// Return       - INT8U: LOCKED, UNLOCKED or INIT if none         //
+////////////////////////////////////////////////////////////////////
+INT8U JournalState(void)
+{
+    return State;
+}
+
+////////////////////////////////////////////////////////////////////
+// JournalWrite - Appends a lock state record if the state has    //
+//                changed. A full segment hands over to the other //
+//                one: erased, the record written, then the       //
+//                header. One erase per JOURNAL_RECORDS state     //
+//                changes, the old segment stays valid until the  //
+//                header of the new one is written.               //
+// Parameters   - INT8U state - LOCKED or UNLOCKED                //
+// Return       - None                                            //
+////////////////////////////////////////////////////////////////////
+void JournalWrite(INT8U state)
+{
+    INT16U spare;
+
+    if (state == State) {
+        return;
+    }
+    if (Next < JOURNAL_RECORDS) {
+        FlashWriteWord(RECORD_ADDR(Seg, Next), JOURNAL_RECORD(state));
+        Next++;
+    } else {
+        spare = (Seg == JOURNAL_SEG_0) ? JOURNAL_SEG_1 : JOURNAL_SEG_0;
+        FlashEraseSegment(spare);
+        FlashWriteWord(RECORD_ADDR(spare, 0), JOURNAL_RECORD(state));
+        // Generation 0xFFFF would read as an erased header
+        Gen = (Gen >= FLASH_ERASED - 1) ? 0 : Gen + 1;
+        FlashWriteWord(spare, Gen);
+        Seg = spare;
+        Next = 1;
+    }
+    State = state;
+}
@@ -0,0 +1,25 @@
+// Forward Facing Journal Functions
+extern void JournalInit(void);
+extern INT8U JournalState(void);
+extern void JournalWrite(INT8U state);
+
+// Lock state journal in information memory segments B and C, used in
+// turn: the header word of the active segment is the newer generation,
+// the rest is a log of one word records, appended until the segment is
+// full. The next record then goes into the other segment, which is
+// erased and written, its header last, before it takes over; the old
+// segment keeps the last state until then and is only erased at the
+// next switch. So the journal always holds a valid state, also after a
+// power loss in an erase. The last valid record is the lock state. A
+// record is the state in the low byte and its complement in the high
+// byte, so an erased word and a write cut short by a power loss (which
+// leaves bits set) are no valid records.
+//
+// The state is the commanded one: ControlTask journals a move when it is
+// queued, not when the motor has completed it. A power loss during the
+// move leaves the new state in the journal with the bolt in between.
+#define JOURNAL_SEG_0           (FLASH_INFO_B)
+#define JOURNAL_SEG_1           (FLASH_INFO_C)
+#define JOURNAL_RECORDS         ((FLASH_INFO_SEG_SIZE / 2) - 1)
+#define JOURNAL_RECORD(state)   ((INT16U)(((INT16U)(~(state) & 0xFF) << 8) | (state)))
+#define JOURNAL_VALID(word)     (((((word) >> 8) ^ (word)) & 0xFF) == 0xFF)
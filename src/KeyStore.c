@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////
+// HEADER FILES - Master, OS, Flash & Key Store module headers.   //
+////////////////////////////////////////////////////////////////////
+#include "includes.h"
+#include "mss/mss.h"
+#include "Auth.h"
+#include "Flash.h"
+#include "KeyStore.h"
+
+////////////////////////////////////////////////////////////////////
+// FUNCTION PROTOTYPES - Key Store Module function prototypes.    //
+////////////////////////////////////////////////////////////////////
+void KeyStoreInit(void);
+INT8U KeyStoreFind(INT16U id, uint32_t *key);
+INT8U KeyStoreAdd(INT16U id, const uint32_t *key);
+INT8U KeyStoreRemove(INT16U id);
+static INT8U KeyStoreProbe(INT16U seg, INT16U id, INT16U word);
+static void KeyStoreWrite(INT16U addr, INT16U id, const uint32_t *key);
+static void KeyStoreRead(INT16U addr, uint32_t *key);
+static void KeyStoreCompact(void);
+
+////////////////////////////////////////////////////////////////////
+// MODULE VARIABLES - Key Store Module Variables.                 //
+////////////////////////////////////////////////////////////////////
+
+static INT16U Seg;                      // active segment
+static INT16U Gen;                      // its generation
+static INT8U Used;                      // programmed slots
+static INT8U Live;                      // enrolled (not revoked) ids
+
+// Address of a slot (its id, the key follows), the header is the first
+// word of the segment. KEYSTORE_SLOT_SIZE is 18, no multiplier needed.
+#define SLOT_ADDR(seg, slot)    ((seg) + 2 + ((slot) << 4) + ((slot) << 1))
+#define KEY_ADDR(slot_addr)     ((slot_addr) + 2)
+
+// Valid key id, the free and revoked markers are none
+#define ID_VALID(id)            ((id) != KEYSTORE_FREE && (id) != KEYSTORE_REVOKED)
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreInit - Finds the active segment (the newer generation  //
+//                if a compaction was interrupted), formats the   //
+//                store on first use and counts the slots. A free //
+//                slot with a programmed key word is the          //
+//                enrollment cut short by a power loss, it is     //
+//                revoked.                                        //
+// Parameters   - None                                            //
+// Return       - None                                            //
+////////////////////////////////////////////////////////////////////
+void KeyStoreInit(void)
+{
+    INT16U gen0 = FlashReadWord(KEYSTORE_SEG_0);
+    INT16U gen1 = FlashReadWord(KEYSTORE_SEG_1);
+    INT16U addr, id;
+    INT8U slot, i;
+
+    if (gen0 == FLASH_ERASED && gen1 == FLASH_ERASED) {
+        FlashEraseSegment(KEYSTORE_SEG_0);
+        FlashWriteWord(KEYSTORE_SEG_0, 0);
+        gen0 = 0;
+    }
+
+    if (gen1 == FLASH_ERASED
+        || (gen0 != FLASH_ERASED && (INT16S)(gen0 - gen1) > 0)) {
+        Seg = KEYSTORE_SEG_0;
+        Gen = gen0;
+    } else {
+        Seg = KEYSTORE_SEG_1;
+        Gen = gen1;
+    }
+
+    Used = 0;
+    Live = 0;
+    for (slot = 0; slot < KEYSTORE_SLOTS; slot++) {
+        addr = SLOT_ADDR(Seg, slot);
+        id = FlashReadWord(addr);
+        for (i = 0; id == KEYSTORE_FREE && i < AUTH_KEY_WORDS * 2; i++) {
+            if (FlashReadWord(KEY_ADDR(addr) + (i << 1)) != FLASH_ERASED) {
+                FlashWriteWord(addr, KEYSTORE_REVOKED);
+                id = KEYSTORE_REVOKED;
+            }
+        }
+        if (id != KEYSTORE_FREE) {
+            Used++;
+            if (id != KEYSTORE_REVOKED) {
+                Live++;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreFind - Reads the key of an enrolled key id, a few      //
+//                probes at most whatever the number of ids       //
+// Parameters   - INT16U id - Key id                              //
+//                uint32_t *key - AUTH_KEY_WORDS words, set if    //
+//                enrolled, else left as it is                    //
+// Return       - INT8U: TRUE if enrolled                         //
+////////////////////////////////////////////////////////////////////
+INT8U KeyStoreFind(INT16U id, uint32_t *key)
+{
+    INT8U slot;
+
+    if (!ID_VALID(id)) {
+        return FALSE;
+    }
+    slot = KeyStoreProbe(Seg, id, id);
+    if (slot >= KEYSTORE_SLOTS) {
+        return FALSE;
+    }
+    KeyStoreRead(KEY_ADDR(SLOT_ADDR(Seg, slot)), key);
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreAdd - Enrolls the key of a key id, it replaces the     //
+//               key of an id which is enrolled already. Compacts //
+//               the store first if the table is at its maximum   //
+//               load.                                            //
+// Parameters  - INT16U id - Key id                               //
+//               const uint32_t *key - AUTH_KEY_WORDS key words   //
+// Return      - INT8U: TRUE if enrolled, FALSE if the id is      //
+//               invalid or the store is full                     //
+////////////////////////////////////////////////////////////////////
+INT8U KeyStoreAdd(INT16U id, const uint32_t *key)
+{
+    if (!ID_VALID(id)) {
+        return FALSE;
+    }
+    // The old key is revoked first, a power loss never leaves it valid
+    KeyStoreRemove(id);
+    if (Live >= KEYSTORE_MAX_USED) {
+        return FALSE;
+    }
+    if (Used >= KEYSTORE_MAX_USED) {
+        KeyStoreCompact();
+    }
+
+    KeyStoreWrite(SLOT_ADDR(Seg, KeyStoreProbe(Seg, id, KEYSTORE_FREE)),
+                  id, key);
+    Used++;
+    Live++;
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreRemove - Revokes a key id and clears its key, the slot //
+//                  stays used until the next compaction          //
+// Parameters     - INT16U id - Key id                            //
+// Return         - INT8U: TRUE if revoked, FALSE if not enrolled //
+////////////////////////////////////////////////////////////////////
+INT8U KeyStoreRemove(INT16U id)
+{
+    INT16U addr;
+    INT8U slot, i;
+
+    if (!ID_VALID(id)) {
+        return FALSE;
+    }
+    slot = KeyStoreProbe(Seg, id, id);
+    if (slot >= KEYSTORE_SLOTS) {
+        return FALSE;
+    }
+    addr = SLOT_ADDR(Seg, slot);
+    FlashWriteWord(addr, KEYSTORE_REVOKED);
+    for (i = 0; i < AUTH_KEY_WORDS * 2; i++) {
+        FlashWriteWord(KEY_ADDR(addr) + (i << 1), 0);
+    }
+    Live--;
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreProbe - Walks the probe sequence of an id, which ends  //
+//                 at the first free slot                         //
+// Parameters    - INT16U seg - Segment                           //
+//                 INT16U id - Key id                             //
+//                 INT16U word - Slot contents looked for: the id //
+//                 itself, or KEYSTORE_FREE for its insertion     //
+// Return        - INT8U: Slot, KEYSTORE_SLOTS if not found       //
+////////////////////////////////////////////////////////////////////
+static INT8U KeyStoreProbe(INT16U seg, INT16U id, INT16U word)
+{
+    INT8U slot = id % KEYSTORE_SLOTS;
+    INT8U n;
+    INT16U read;
+
+    for (n = 0; n < KEYSTORE_SLOTS; n++) {
+        read = FlashReadWord(SLOT_ADDR(seg, slot));
+        if (read == word) {
+            return slot;
+        }
+        if (read == KEYSTORE_FREE) {
+            break;
+        }
+        slot = (slot == KEYSTORE_SLOTS - 1) ? 0 : slot + 1;
+    }
+    return KEYSTORE_SLOTS;
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreWrite - Programs a free slot: the key first, the id    //
+//                 last, so that a slot cut short by a power loss //
+//                 has no id (see KeyStoreInit)                   //
+// Parameters    - INT16U addr - Slot address                     //
+//                 INT16U id - Key id                             //
+//                 const uint32_t *key - AUTH_KEY_WORDS key words //
+// Return        - None                                           //
+////////////////////////////////////////////////////////////////////
+static void KeyStoreWrite(INT16U addr, INT16U id, const uint32_t *key)
+{
+    INT8U i;
+
+    for (i = 0; i < AUTH_KEY_WORDS; i++) {
+        FlashWriteWord(KEY_ADDR(addr) + (i << 2), (INT16U)key[i]);
+        FlashWriteWord(KEY_ADDR(addr) + (i << 2) + 2, (INT16U)(key[i] >> 16));
+    }
+    FlashWriteWord(addr, id);
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreRead - Reads the key of a slot                         //
+// Parameters   - INT16U addr - Address of the key in the slot    //
+//                uint32_t *key - AUTH_KEY_WORDS words, set       //
+// Return       - None                                            //
+////////////////////////////////////////////////////////////////////
+static void KeyStoreRead(INT16U addr, uint32_t *key)
+{
+    INT8U i;
+
+    for (i = 0; i < AUTH_KEY_WORDS; i++) {
+        key[i] = FlashReadWord(addr + (i << 2))
+                 | ((uint32_t)FlashReadWord(addr + (i << 2) + 2) << 16);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// KeyStoreCompact - Copies the enrolled keys into the erased     //
+//                   spare segment and makes it the active one by //
+//                   writing its header last. The old segment is  //
+//                   left as it is (older generation) and erased  //
+//                   when it is the spare of the next compaction, //
+//                   one erase per compaction.                    //
+// Parameters      - None                                         //
+// Return          - None                                         //
+////////////////////////////////////////////////////////////////////
+static void KeyStoreCompact(void)
+{
+    INT16U spare = (Seg == KEYSTORE_SEG_0) ? KEYSTORE_SEG_1 : KEYSTORE_SEG_0;
+    uint32_t key[AUTH_KEY_WORDS];
+    INT16U id;
+    INT8U slot;
+
+    FlashEraseSegment(spare);
+
+    Used = 0;
+    for (slot = 0; slot < KEYSTORE_SLOTS; slot++) {
+        id = FlashReadWord(SLOT_ADDR(Seg, slot));
+        if (ID_VALID(id)) {
+            KeyStoreRead(KEY_ADDR(SLOT_ADDR(Seg, slot)), key);
+            KeyStoreWrite(SLOT_ADDR(spare,
+                          KeyStoreProbe(spare, id, KEYSTORE_FREE)), id, key);
+            Used++;
+        }
+    }
+
+    // Generation 0xFFFF would read as an erased header
+    Gen = (Gen == FLASH_ERASED - 1) ? 0 : Gen + 1;
+    FlashWriteWord(spare, Gen);
+    Seg = spare;
+}
@@ -0,0 +1,21 @@
+// Forward Facing Key Store Functions
+extern void KeyStoreInit(void);
+extern INT8U KeyStoreFind(INT16U id, uint32_t *key);
+extern INT8U KeyStoreAdd(INT16U id, const uint32_t *key);
+extern INT8U KeyStoreRemove(INT16U id);
+
+// Enrolled keys in the KEYS region: one segment is active (header word:
+// generation), the other one is the spare of the next compaction. The
+// rest of a segment is an open addressing hash table of slots (key id,
+// then the AUTH_KEY_WORDS key words) with linear probing on the id,
+// written append-only: a key is programmed into a free (erased) slot,
+// its id last, and revoked by programming the id to KEYSTORE_REVOKED and
+// the key to 0. Only a compaction, once the revoked slots fill the
+// table, erases a segment.
+#define KEYSTORE_SEG_0          (FLASH_KEYS)
+#define KEYSTORE_SEG_1          (FLASH_KEYS + FLASH_MAIN_SEG_SIZE)
+#define KEYSTORE_SLOT_SIZE      (2 + AUTH_KEY_WORDS * 4)
+#define KEYSTORE_SLOTS          ((FLASH_MAIN_SEG_SIZE - 2) / KEYSTORE_SLOT_SIZE)
+#define KEYSTORE_MAX_USED       (21)      // load factor <= 0.75
+#define KEYSTORE_FREE           (FLASH_ERASED)
+#define KEYSTORE_REVOKED        (0x0000)
@@ -1,29 +1,78 @@
 ////////////////////////////////////////////////////////////////////
-// HEADER FILES - Master & Motor module headers.                  //
+// HEADER FILES - Master, OS, Motor & Current module headers.     //
 ////////////////////////////////////////////////////////////////////
 #include "includes.h"
+#include "mss/mss.h"
 #include "Motor.h"
+#include "Current.h"
 
 ////////////////////////////////////////////////////////////////////
 // FUNCTION PROTOTYPES - Motor Module function prototypes.        //
 ////////////////////////////////////////////////////////////////////
 void MotorInit(void);
-INT8U MotorEnable2s(void);
-void MotorOut(void);
-void MotorIn(void);
+void MotorHome(void);
+INT8U MotorOut(void);
+INT8U MotorIn(void);
+void MotorStop(INT8U stalled);
+void MotorReport(INT8U *buf);
+INT8U MotorDone(INT8U *buf);
+INT8U MotorSetProfile(INT8U dir, INT16U time, const INT8U *curve);
+static INT8U MotorQueue(INT8U dir);
+static void MotorNext(void);
+static void MotorRun(INT16U time);
+static bool MotorTimer(void);
 
 ////////////////////////////////////////////////////////////////////
 // MODULE VARIABLES - Motor Module Variables.                     //
 ////////////////////////////////////////////////////////////////////
-INT8U Enabled;
 typedef enum {
-    PUSH,
-    PULL
+    PUSH = MOTOR_DIR_OUT,
+    PULL = MOTOR_DIR_IN
 } MOTOR_STATE;
 MOTOR_STATE MotorState = PULL;
 
+// State machine, advanced by the expiry of the Timer0_A channel
+typedef enum {
+    MOTOR_IDLE,                         // queue empty
+    MOTOR_RUNNING,                      // enabled until soft stop or stall
+    MOTOR_STOPPING,                     // soft stop ramp, then off
+    MOTOR_PAUSED                        // off for MOTOR_PAUSE_TIME
+} MOTOR_PHASE;
+static MOTOR_PHASE Phase = MOTOR_IDLE;
+static INT8U TimerCh;                   // compare channel of Timer0_A
+
+// Command queue of directions, MotorIn/MotorOut append
+static INT8U Queue[MOTOR_QUEUE_LEN];
+static INT8U QueueHead;
+static INT8U QueueCount;
+
+// Enable time and power curve per direction (MotorSetProfile)
+static const INT8U MotorCurve[MOTOR_RAMP_STEPS] = {
+    25, 50, 80, 110, 150, 190, 225, MOTOR_PWM_PERIOD
+};
+static INT16U Time[2] = { MOTOR_TIME_OUT, MOTOR_TIME_IN };
+static const INT8U *Curve[2] = { MotorCurve, MotorCurve };
+
+// Ramp of the running actuation, walked by the Timer1_A CCR0 ISR
+static INT8U RampStep;                  // index into the curve
+static INT8U RampHold;                  // PWM periods left on the step
+static INT8U RampUp;                    // TRUE soft start, FALSE soft stop
+
+// Outcome of the last actuation
+INT8U Stalled;                          // cut by stall detection
+INT16U RunStart;                        // mss timer tick of the start
+INT16U RunTime;                         // ms enabled
+INT16U RunPeak;                         // peak current, ADC10 counts
+
+// Reports of ended moves, MotorStop (ISR) writes at DoneIn, MotorDone
+// (task) reads at DoneOut, each index has a single writer
+static INT8U Done[MOTOR_DONE_LEN][MOTOR_REPORT_LEN];
+static INT8U DoneIn;
+static INT8U DoneOut;
+
 ////////////////////////////////////////////////////////////////////
-// MotorInit  - Initializes motor timer & set to in state         //
+// MotorInit  - Initializes motor timer, the motor stays where it //
+//              is (the lock state is restored from the journal)  //
 // Parameters - None                                              //
 // Return     - None                                              //
 ////////////////////////////////////////////////////////////////////
@@ -31,77 +80,263 @@ void MotorInit(void)
 {
     // Set as output for IN1, IN2, EN on H-Bridge
     P2DIR |= 0x23;
+    MOTOR_DISABLE;
 
-    // Initialize Timer A.
-    BCSCTL3 = LFXT1S1;                        //Select VLOCLK for ACLCK (i.e. 12khz intosc)
-    TACCTL0 = OUTMOD_2 + CCIE;                // TACCR0 interrupt enabled
+    // PWM for EN, reset/set: high from 0 up to TA1CCR2. Timer1_A runs
+    // from here on and is never stopped or cleared, an actuation only
+    // takes the pin (MOTOR_ENABLE) and the period interrupt.
+    TA1CCR0 = MOTOR_PWM_PERIOD - 1;
+    TA1CCR2 = 0;
+    TA1CCTL2 = OUTMOD_7;
+    TA1CTL = TASSEL_2 + MC_1 + TACLR;       // SMCLK, upmode to TA1CCR0 value
 
-    // This returns motor to unlocked state on init
+    // Enable and pause times
+    TimerCh = mss_hal_timer_alloc(MotorTimer);
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorHome  - Returns motor to unlocked state with a long run,  //
+//              when the lock state is not known (first boot)     //
+// Parameters - None                                              //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+void MotorHome(void)
+{
     MOTOR_UNLOCK;
+    MotorState = PULL;
+    MotorRun(MOTOR_TIME_HOME);
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorRun   - Enables the motor with a soft start for the time  //
+//              given, the soft stop ramp is the end of it        //
+// Parameters - INT16U time: ms                                   //
+// Return     - None                                              //
+////////////////////////////////////////////////////////////////////
+static void MotorRun(INT16U time)
+{
+    Phase = MOTOR_RUNNING;
+
+    // PWM from the first step of the curve
+    RampStep = 0;
+    RampHold = MOTOR_RAMP_HOLD;
+    RampUp = TRUE;
+    TA1CCR2 = Curve[MotorState][0];
+    TA1CCTL0 = CCIE;                        // no stale CCIFG
     MOTOR_ENABLE;
-    TACCR0 = TACCR0_INIT;
-    TACTL = TASSEL_1 + ID1 + ID0 + MC_1;    // ACLCK, 1/40 DIVIDER, upmode to TCCR0 value
+
+    RunStart = mss_timer_get_tick_cnt();
+    mss_hal_timer_start(TimerCh,
+        MSS_HAL_TIMER_US((INT32U)(time - MOTOR_RAMP_TIME) * 1000));
+    CurrentStart();
 }
 
 ////////////////////////////////////////////////////////////////////
-// MotorEnable2s - Initializes motor timer & set to in state      //
-// Parameters    - None                                           //
-// Return        - INT8U: Enable outcome                          //
+// MotorSetProfile - Sets enable time and power curve of a        //
+//                   direction, from the next actuation on        //
+// Parameters      - INT8U dir: MOTOR_DIR_OUT or MOTOR_DIR_IN     //
+//                   INT16U time: ms, ramps included              //
+//                   const INT8U *curve: MOTOR_RAMP_STEPS duty    //
+//                   cycles, kept by the caller                   //
+// Return          - INT8U: FALSE if the time is too short        //
 ////////////////////////////////////////////////////////////////////
-INT8U MotorEnable2s(void)
+INT8U MotorSetProfile(INT8U dir, INT16U time, const INT8U *curve)
 {
-    // Motor is already moving
-    if (Enabled == TRUE) {
+    if (dir > MOTOR_DIR_IN || time <= 2 * MOTOR_RAMP_TIME) {
         return FALSE;
     }
-    MOTOR_ENABLE;
-    Enabled = TRUE;
-    TAR = 0;                                // Set the timer.
-    TACCR0 = TACCR0_CNT;
-    // Increase in time.
-    if (MotorState == PULL) {
-        TACCR0 += 20;
-    }
-    TACTL = TASSEL_1 + ID1 + ID0 + MC_1;    // ACLCK, 1/40 DIVIDER, upmode to TCCR0 value
+    Time[dir] = time;
+    Curve[dir] = curve;
 
     return TRUE;
 }
 
 ////////////////////////////////////////////////////////////////////
-// MotorIn    - Puts the motor to the in state                    //
+// MotorIn    - Queues a move to the in state                     //
 // Parameters - None                                              //
-// Return     - None                                              //
+// Return     - INT8U: FALSE if the queue is full                 //
 ////////////////////////////////////////////////////////////////////
-void MotorIn(void)
+INT8U MotorIn(void)
 {
-    if (Enabled != TRUE) {
-        MOTOR_UNLOCK;
-        MotorState = PULL;
+    return MotorQueue(PULL);
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorOut   - Queues a move to the out state                    //
+// Parameters - None                                              //
+// Return     - INT8U: FALSE if the queue is full                 //
+////////////////////////////////////////////////////////////////////
+INT8U MotorOut(void)
+{
+    return MotorQueue(PUSH);
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorQueue - Appends a move, it starts right away when the     //
+//              motor is idle                                     //
+// Parameters - INT8U dir: PUSH or PULL                           //
+// Return     - INT8U: FALSE if the queue is full                 //
+////////////////////////////////////////////////////////////////////
+static INT8U MotorQueue(INT8U dir)
+{
+    mss_int_flag_t int_flag;
+    INT8U ok = FALSE;
+
+    MSS_ENTER_CRITICAL_SECTION(int_flag);
+    if (QueueCount < MOTOR_QUEUE_LEN) {
+        Queue[(QueueHead + QueueCount) % MOTOR_QUEUE_LEN] = dir;
+        QueueCount++;
+        if (Phase == MOTOR_IDLE) {
+            MotorNext();
+        }
+        ok = TRUE;
     }
+    MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+    return ok;
 }
 
 ////////////////////////////////////////////////////////////////////
-// MotorOut   - Puts the motor to the out state                   //
+// MotorNext  - Starts the next queued move, or goes idle         //
 // Parameters - None                                              //
 // Return     - None                                              //
 ////////////////////////////////////////////////////////////////////
-void MotorOut(void)
+static void MotorNext(void)
 {
-    if (Enabled != TRUE) {
+    if (QueueCount == 0) {
+        Phase = MOTOR_IDLE;
+        return;
+    }
+    MotorState = (MOTOR_STATE)Queue[QueueHead];
+    QueueHead = (QueueHead + 1) % MOTOR_QUEUE_LEN;
+    QueueCount--;
+
+    if (MotorState == PULL) {
+        MOTOR_UNLOCK;
+    } else {
         MOTOR_LOCK;
-        MotorState = PUSH;
     }
+    MotorRun(Time[MotorState]);
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorStop  - Disables the motor, queues the outcome, signals   //
+//              MOTOR_EVENT_DONE and pauses before the next move. //
+//              The calling ISR wakes up the CPU.                 //
+// Parameters - INT8U stalled: TRUE from stall detection, FALSE   //
+//              when the timer hits                               //
+// Return     - None (ISR only)                                   //
+////////////////////////////////////////////////////////////////////
+void MotorStop(INT8U stalled)
+{
+    // Stall and timer can hit together, the first one counts
+    if (Phase != MOTOR_RUNNING && Phase != MOTOR_STOPPING) {
+        return;
+    }
+    MOTOR_DISABLE;       // Disable Motor, PWM off the pin
+    TA1CCTL0 = 0;
+    mss_hal_timer_stop(TimerCh);
+    CurrentStop();
+
+    Stalled = stalled;
+    RunTime = mss_timer_get_tick_cnt() - RunStart;
+    RunPeak = CurrentPeak();
+    MotorReport(Done[DoneIn & (MOTOR_DONE_LEN-1)]);
+    DoneIn++;
+
+    // The bridge settles before it is driven again
+    if (QueueCount > 0) {
+        Phase = MOTOR_PAUSED;
+        mss_hal_timer_start(TimerCh,
+            MSS_HAL_TIMER_US((INT32U)MOTOR_PAUSE_TIME * 1000));
+    } else {
+        Phase = MOTOR_IDLE;
+    }
+
+    mss_event_set(CNTL_TSK_ID, MOTOR_EVENT_DONE);
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorReport - Writes the outcome of the last actuation: stall  //
+//               or timeout, the run time and the peak current    //
+// Parameters  - INT8U *buf: MOTOR_REPORT_LEN bytes               //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void MotorReport(INT8U *buf)
+{
+    buf[0] = (Stalled == TRUE) ? MOTOR_STALL_CH : MOTOR_TIMEOUT_CH;
+    buf[1] = RunTime & 0xFF;
+    buf[2] = RunTime >> 8;
+    buf[3] = RunPeak & 0xFF;
+    buf[4] = RunPeak >> 8;
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorDone  - Takes the report of the oldest ended move, one    //
+//              per actuation, see MotorReport                    //
+// Parameters - INT8U *buf: MOTOR_REPORT_LEN bytes                //
+// Return     - INT8U: TRUE if a report was taken, FALSE if none  //
+////////////////////////////////////////////////////////////////////
+INT8U MotorDone(INT8U *buf)
+{
+    INT8U i;
+
+    if (DoneOut == DoneIn) {
+        return FALSE;
+    }
+    for (i = 0; i < MOTOR_REPORT_LEN; i++) {
+        buf[i] = Done[DoneOut & (MOTOR_DONE_LEN-1)][i];
+    }
+    DoneOut++;
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////
+// MotorTimer - Timer0_A channel expired: starts the soft stop    //
+//              ramp, disables the motor at its end, or starts    //
+//              the next queued move after the pause              //
+// Parameters - None                                              //
+// Return     - bool: true to wake up the CPU (called from ISR)   //
+////////////////////////////////////////////////////////////////////
+static bool MotorTimer(void)
+{
+    if (Phase == MOTOR_RUNNING) {
+        Phase = MOTOR_STOPPING;
+        RampUp = FALSE;
+        RampHold = MOTOR_RAMP_HOLD;
+        TA1CCTL0 = CCIE;
+        mss_hal_timer_start(TimerCh,
+            MSS_HAL_TIMER_US((INT32U)MOTOR_RAMP_TIME * 1000));
+        return false;
+    }
+    if (Phase == MOTOR_STOPPING) {
+        MotorStop(FALSE);
+        return true;
+    }
+    MotorNext();
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////////
-// Timer_A    - Disables the motor when timer hits                //
+// Timer1_A0  - Walks the power curve, once per PWM period while  //
+//              ramping, so TA1CCR2 changes between two pulses    //
 // Parameters - None                                              //
 // Return     - __interrupt                                       //
 ////////////////////////////////////////////////////////////////////
-#pragma vector=TIMER0_A0_VECTOR        // Timer A0 interrupt service routine
-__interrupt void Timer_A (void)
+#pragma vector=TIMER1_A0_VECTOR
+__interrupt void Timer1_A0 (void)
 {
-    TACTL = MC_0;        // Timer Halted
-    MOTOR_DISABLE;        // Disable Motor
-    Enabled = FALSE;
+    if (--RampHold != 0) {
+        return;
+    }
+    RampHold = MOTOR_RAMP_HOLD;
+
+    // Interrupts off at the end of a ramp until the next one
+    if (RampUp == TRUE && RampStep < MOTOR_RAMP_STEPS - 1) {
+        TA1CCR2 = Curve[MotorState][++RampStep];
+    } else if (RampUp != TRUE && RampStep > 0) {
+        TA1CCR2 = Curve[MotorState][--RampStep];
+    } else {
+        TA1CCTL0 = 0;
+    }
 }
@@ -1,8 +1,12 @@
 // Forward Facing Motor Functions
 extern void MotorInit(void);
-extern void MotorIn(void);
-extern void MotorOut(void);
-extern INT8U MotorEnable2s(void);
+extern void MotorHome(void);
+extern INT8U MotorIn(void);
+extern INT8U MotorOut(void);
+extern void MotorStop(INT8U stalled);
+extern void MotorReport(INT8U *buf);
+extern INT8U MotorDone(INT8U *buf);
+extern INT8U MotorSetProfile(INT8U dir, INT16U time, const INT8U *curve);
 
 // Lock States
 typedef enum {
@@ -11,14 +15,45 @@ typedef enum {
 	INIT
 } LOCK_STATE;
 
-// TACCR0: VLOCLK = 12 kHz. TAACR0 is 8 Bits.
-//         Timer A Uses 12 kHz / 8 = 1.5 kHz
-//         TACCR0 = Second * 1.5 kHz - 1
-#define TACCR0_CNT       3500
-#define TACCR0_INIT      8520
+// Enable times in ms, timed by a compare channel of the shared Timer0_A
+// (mss_hal_timer_alloc): the long run of MotorHome and the defaults of the
+// directions of MotorSetProfile
+#define MOTOR_TIME_HOME  5680
+#define MOTOR_DIR_OUT    0               // lock
+#define MOTOR_DIR_IN     1               // unlock
+#define MOTOR_TIME_OUT   2333
+#define MOTOR_TIME_IN    2347
+
+// PWM of the H-bridge EN pin P2.5 (TA1.2): Timer1_A from SMCLK (1 MHz),
+// MOTOR_PWM_PERIOD counts = 4 kHz. A power curve is MOTOR_RAMP_STEPS
+// duty cycles in counts (MOTOR_PWM_PERIOD is full on), each held for
+// MOTOR_RAMP_HOLD periods: walked up at the start (soft start), the last
+// one is the running power, and walked down before the end (soft stop).
+#define MOTOR_PWM_PERIOD 250
+#define MOTOR_RAMP_STEPS 8
+#define MOTOR_RAMP_HOLD  40              // 10 ms
+// Ramp length in ms, 80 ms
+#define MOTOR_RAMP_TIME  ((INT16U)((MOTOR_RAMP_STEPS * MOTOR_RAMP_HOLD \
+                          * (INT32U)MOTOR_PWM_PERIOD) / 1000))
+
+// Command queue: MotorIn/MotorOut append a move and return at once, the
+// Timer0_A ISR runs them in order with MOTOR_PAUSE_TIME (ms) between two,
+// and sets MOTOR_EVENT_DONE of the control task at the end of each move
+#define MOTOR_QUEUE_LEN  4
+#define MOTOR_PAUSE_TIME 50
+#define MOTOR_EVENT_DONE 0x01
+
+// MotorReport: result char, run time in ms and peak current
+// in ADC10 counts, both little endian
+#define MOTOR_REPORT_LEN 5
+
+// Reports of ended moves not yet taken by MotorDone. The control task
+// takes them all before it queues a move, so at most the queue and the
+// running move end in between; a power of 2
+#define MOTOR_DONE_LEN   8
 
 // Macros
 #define MOTOR_UNLOCK     P2OUT &= ~0x01; P2OUT |= 0x02
 #define MOTOR_LOCK       P2OUT |= 0x01; P2OUT &= ~0x02
-#define MOTOR_ENABLE     P2OUT |= BIT5
-#define MOTOR_DISABLE    P2OUT &= ~BIT5
+#define MOTOR_ENABLE     P2SEL |= BIT5                 // EN from TA1.2
+#define MOTOR_DISABLE    P2SEL &= ~BIT5; P2OUT &= ~BIT5
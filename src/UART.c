@@ -1,18 +1,33 @@
 ////////////////////////////////////////////////////////////////////
-// HEADER FILES - Master & UART module headers.                   //
+// HEADER FILES - Master, OS, UART & Frame module headers.        //
 ////////////////////////////////////////////////////////////////////
 #include "includes.h"
+#include "mss/mss.h"
 #include "UART.h"
-
-INT8U RxChar = 0x00;
+#include "Frame.h"
 
 ////////////////////////////////////////////////////////////////////
 // FUNCTION PROTOTYPES - UART Module function prototypes.         //
 ////////////////////////////////////////////////////////////////////
 void UARTInit(void);
+static bool UARTRxTimeout(void);
 void UARTPutChar(INT8U ch);
 void UARTPutStr(const INT8U *str);
-INT8U UARTGetChar(void);
+#if (MSS_TASK_STATS == TRUE)
+void UARTPutDec(INT32U value);
+void UARTPutTaskStats(void);
+#endif
+#if (MSS_TRACE == TRUE)
+void UARTPutTrace(void);
+#endif
+#if (MSS_LATENCY_STATS == TRUE)
+void UARTPutLatency(void);
+#endif
+
+////////////////////////////////////////////////////////////////////
+// MODULE VARIABLES - UART Module Variables.                      //
+////////////////////////////////////////////////////////////////////
+static INT8U TimerCh;                   // compare channel of Timer0_A
 
 ////////////////////////////////////////////////////////////////////
 // UARTInit   - Initializes a full duplex UART protocol           //
@@ -32,6 +47,21 @@ void UARTInit(void)
     UCA0MCTL = UCBRS2 + UCBRS0;               // Modulation UCBRSx = 5
     UCA0CTL1 &= ~UCSWRST;                     // **Initialize USCI state machine**
     IE2 |= UCA0RXIE;                          // Enable USCI_A0 RX interrupt
+
+    // Receive timeout between the bytes of a frame
+    TimerCh = mss_hal_timer_alloc(UARTRxTimeout);
+}
+
+////////////////////////////////////////////////////////////////////
+// UARTRxTimeout - No byte for UART_RX_TIMEOUT_MS within a frame, //
+//                 the parser hunts for the next SOF              //
+// Parameters    - None                                           //
+// Return        - bool: false, no task to wake (called from ISR) //
+////////////////////////////////////////////////////////////////////
+static bool UARTRxTimeout(void)
+{
+    FrameRxTimeout();
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -63,24 +93,147 @@ void UARTPutStr(const INT8U *str)
     }
 }
 
+#if (MSS_TASK_STATS == TRUE)
+////////////////////////////////////////////////////////////////////
+// UARTPutDec  - Sends an unsigned number in decimal over UART    //
+// Parameters  - INT32U value - Number to be sent                 //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void UARTPutDec(INT32U value)
+{
+    INT8U digits[10];
+    INT8U num_digits = 0;
+
+    do {
+        digits[num_digits++] = '0' + (INT8U)(value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (num_digits > 0) {
+        UARTPutChar(digits[--num_digits]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+// UARTPutTaskStats - Dumps the CPU time and activation stats of  //
+//                    every task slot, one line per task:         //
+//                    T<id> run max runs act react (times in us)  //
+// Parameters  - None                                             //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void UARTPutTaskStats(void)
+{
+    INT8U task_id;
+    mss_task_stats_t stats;
+
+    for (task_id = 0; task_id < MSS_NUM_OF_TASKS; task_id++) {
+        mss_task_get_stats(task_id, &stats);
+
+        UARTPutChar('T');
+        UARTPutDec(task_id);
+        UARTPutChar(' ');
+        UARTPutDec(stats.run_time * MSS_TIMESTAMP_US);
+        UARTPutChar(' ');
+        UARTPutDec((INT32U)stats.max_run_time * MSS_TIMESTAMP_US);
+        UARTPutChar(' ');
+        UARTPutDec(stats.runs);
+        UARTPutChar(' ');
+        UARTPutDec(stats.activations);
+        UARTPutChar(' ');
+        UARTPutDec(stats.reactivations);
+        UARTPutStr((const INT8U *)"\r\n");
+    }
+}
+#endif
+
+#if (MSS_LATENCY_STATS == TRUE)
 ////////////////////////////////////////////////////////////////////
-// UARTGetChar - Returns the current character in the UART Buffer //
+// UARTPutLatency - Dumps the ISR-to-task latency stats of every  //
+//                  source, one line per source:                  //
+//                  L<src> min avg max count hist0 .. histN       //
+//                  (times in timestamp counts)                   //
 // Parameters  - None                                             //
-// Return      - INT8U: Buffer Char                               //
+// Return      - None                                             //
+////////////////////////////////////////////////////////////////////
+void UARTPutLatency(void)
+{
+    INT8U src, bucket;
+    mss_latency_stats_t stats;
+
+    for (src = 0; src < MSS_LATENCY_NUM_OF_SRC; src++) {
+        mss_latency_get_stats(src, &stats);
+
+        UARTPutChar('L');
+        UARTPutDec(src);
+        UARTPutChar(' ');
+        UARTPutDec(stats.cnt ? stats.min : 0);
+        UARTPutChar(' ');
+        UARTPutDec(stats.cnt ? stats.sum / stats.cnt : 0);
+        UARTPutChar(' ');
+        UARTPutDec(stats.max);
+        UARTPutChar(' ');
+        UARTPutDec(stats.cnt);
+        for (bucket = 0; bucket < MSS_LATENCY_NUM_OF_BUCKETS; bucket++) {
+            UARTPutChar(' ');
+            UARTPutDec(stats.hist[bucket]);
+        }
+        UARTPutStr((const INT8U *)"\r\n");
+    }
+}
+#endif
+
+#if (MSS_TRACE == TRUE)
+////////////////////////////////////////////////////////////////////
+// UARTPutTrace - Sends the scheduler trace records recorded since //
+//                the last dump as binary frame: 'M' 'T', 4 byte   //
+//                records (event, task id, timestamp LSB, MSB),    //
+//                terminated by 0xFF 0xFF 0xFF 0xFF                //
+//                (see tools/mss_trace2json.py)                    //
+// Parameters   - None                                             //
+// Return       - None                                             //
 ////////////////////////////////////////////////////////////////////
-INT8U UARTGetChar(void)
+void UARTPutTrace(void)
 {
-    return RxChar;
+    static INT16U trace_pos = 0;
+    mss_trace_rec_t rec;
+
+    UARTPutChar('M');
+    UARTPutChar('T');
+
+    while (mss_trace_read(&trace_pos, &rec)) {
+        UARTPutChar(rec.event);
+        UARTPutChar(rec.task_id);
+        UARTPutChar((INT8U)rec.timestamp);
+        UARTPutChar((INT8U)(rec.timestamp >> 8));
+    }
+
+    UARTPutChar(0xFF);
+    UARTPutChar(0xFF);
+    UARTPutChar(0xFF);
+    UARTPutChar(0xFF);
 }
+#endif
 
 ////////////////////////////////////////////////////////////////////
-// USCI0RX_ISR - UART ISR for receiving character                 //
+// USCI0RX_ISR - UART ISR for receiving character, wakes the     //
+//               control task once a whole frame is received,     //
+//               restarts the receive timeout otherwise           //
 // Parameters  - None                                             //
 // Return      - __interrupt                                      //
 ////////////////////////////////////////////////////////////////////
 #pragma vector=USCIAB0RX_VECTOR
 __interrupt void USCI0RX_ISR(void)
 {
-    RxChar = UCA0RXBUF;
+    MSS_LATENCY_ISR_STAMP(entry);           // before the frame handling
+
+    if (FrameRxByte(UCA0RXBUF) == TRUE) {
+        MSS_LATENCY_ISR_RECORD(LAT_SRC_UART, CNTL_TSK_ID, entry);
+        mss_hal_timer_stop(TimerCh);
+        mss_activate_task(CNTL_TSK_ID);
+        MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_UART);
+    } else {
+        mss_hal_timer_start(TimerCh,
+            MSS_HAL_TIMER_US((INT32U)UART_RX_TIMEOUT_MS * 1000));
+    }
 }
 
@@ -2,4 +2,11 @@
 extern void UARTInit(void);
 extern void UARTPutChar(INT8U ch);
 extern void UARTPutStr(const INT8U *str);
-extern INT8U UARTGetChar(void);
+extern void UARTPutDec(INT32U value);
+extern void UARTPutTaskStats(void);
+extern void UARTPutTrace(void);
+extern void UARTPutLatency(void);
+
+// Receive timeout between two bytes of a frame (a byte takes 87 us at
+// 115200 Bd, the margin is for gateways sending in bursts)
+#define UART_RX_TIMEOUT_MS  (20)
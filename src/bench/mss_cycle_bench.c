@@ -0,0 +1,546 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_cycle_bench.c
+* 
+* @brief    cycle benchmark firmware of the MSS primitives and of the
+*           command authentication (src/Auth.c)
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_CYCLE_BENCH is
+*           defined (see src/bench/Makefile), it replaces main() of
+*           src/main.c. Every operation is measured with Timer0_A counting
+*           MCLK cycles for BENCH_REPS repetitions and for a growing number
+*           of live objects of its kind (message bytes for the MAC), with
+*           interrupts disabled and without the scheduler running. The
+*           results are left in mss_bench_result for
+*           tools/mss_cycle_bench.py, which reads them at the breakpoint
+*           mss_bench_done.
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "includes.h"
+#include "mss.h"
+#include "mss_int.h"
+#include "Auth.h"
+#include "Cred.h"
+
+#if defined(MSS_CYCLE_BENCH)
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+/** BENCH_OP_xxx
+ *  measured operations, in the order of OPS in tools/mss_cycle_bench.py
+ */
+#define BENCH_OP_ACTIVATE          (0)
+#define BENCH_OP_TIMER_START       (1)
+#define BENCH_OP_TIMER_STOP        (2)
+#define BENCH_OP_SEMA_WAIT         (3)
+#define BENCH_OP_SEMA_POST         (4)
+#define BENCH_OP_MQUE_SEND         (5)
+#define BENCH_OP_MQUE_READ         (6)
+#define BENCH_OP_MEM_ALLOC         (7)
+#define BENCH_OP_MEM_FREE          (8)
+#define BENCH_OP_AUTH_MAC          (9)
+#define BENCH_OP_AUTH_CHECK        (10)
+#define BENCH_NUM_OF_OPS           (11)
+
+/** BENCH_NUM_OF_N
+ *  number of live object counts every operation is measured with
+ */
+#define BENCH_NUM_OF_N             (6)
+
+/** BENCH_MAX_N
+ *  highest number of live objects (ready tasks, running timers, waiting
+ *  tasks, queued messages, allocated blocks)
+ */
+#define BENCH_MAX_N                (12)
+
+/** BENCH_REPS
+ *  repetitions of every measurement, the result is the average
+ */
+#define BENCH_REPS                 (8)
+
+/** BENCH_TASK_ID
+ *  task measured by mss_activate_task and holding the semaphore, below the
+ *  ready or waiting tasks 0 .. BENCH_MAX_N-1
+ */
+#define BENCH_TASK_ID              (MSS_NUM_OF_TASKS - 1)
+
+/** BENCH_TIMEOUT
+ *  timeout of the measured timer, after the ones of the running timers
+ */
+#define BENCH_TIMEOUT              (1000)
+
+/** mss_bench_result_t
+ *  benchmark results, read by tools/mss_cycle_bench.py
+ */
+typedef struct {
+  uint16_t num_of_ops;
+  uint16_t num_of_n;
+  uint16_t n[BENCH_NUM_OF_N];
+  uint16_t cycles[BENCH_NUM_OF_OPS][BENCH_NUM_OF_N];
+} mss_bench_result_t;
+
+/** BENCH_START, BENCH_STOP
+ *  measure the cycles of the code in between, added to sum
+ */
+#define BENCH_START()              (bench_start = TA0R)
+#define BENCH_STOP(sum)            ((sum) += (uint16_t)(TA0R - bench_start))
+
+// live object counts
+static const uint16_t bench_n[BENCH_NUM_OF_N] = {0, 1, 2, 4, 8, BENCH_MAX_N};
+
+// timer value at BENCH_START
+static volatile uint16_t bench_start;
+
+// cycles of an empty BENCH_START/BENCH_STOP pair
+static uint16_t bench_overhead;
+
+// timers, messages and memory blocks of the measurements
+static mss_timer_t timer[BENCH_MAX_N + 1];
+static mss_mque_msg_t msg[BENCH_MAX_N + 1];
+static void* block[BENCH_MAX_N + 1];
+
+// message, key and credentials (key id, tag) of the MAC measurements
+static INT8U auth_msg[BENCH_MAX_N];
+static const uint32_t auth_key[AUTH_KEY_WORDS] = {1, 2, 3, 4};
+static INT8U auth_cred[AUTH_CRED_LEN];
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+/** mss_bench_result
+ *  benchmark results, average cycles per operation without the measurement
+ *  overhead
+ */
+volatile mss_bench_result_t mss_bench_result;
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+static void bench_put(uint8_t op, uint8_t n_idx, uint16_t sum);
+static void bench_activate(uint8_t n_idx);
+static void bench_timer(uint8_t n_idx);
+static void bench_sema(uint8_t n_idx, mss_sema_t sema);
+static void bench_mque(uint8_t n_idx, mss_mque_t mque);
+static void bench_mem(uint8_t n_idx, mss_mem_t mem);
+static void bench_auth(uint8_t n_idx);
+void mss_bench_done(void);
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* main
+*
+* @brief      run all benchmarks and stop at mss_bench_done
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void main(void)
+{
+  mss_sema_t sema;
+  mss_mque_t mque;
+  mss_mem_t mem;
+  uint16_t sum = 0;
+  uint8_t i;
+
+  WDTCTL = WDTPW + WDTHOLD;
+
+  mss_init();
+  CredInit();
+
+  // no WDT tick or any other interrupt during the measurements
+  __disable_interrupt();
+  WDTCTL = WDTPW + WDTHOLD;
+
+  // SMCLK = MCLK (mss_hal_init divides it by 8), Timer0_A counts cycles
+  BCSCTL2 &= ~DIVS_3;
+  TA0CTL = TASSEL_2 | MC_2 | TACLR;
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    BENCH_START();
+    BENCH_STOP(sum);
+  }
+  bench_overhead = sum / BENCH_REPS;
+
+  for(i=0 ; i<=BENCH_MAX_N ; i++)
+  {
+    timer[i] = mss_timer_create(BENCH_TASK_ID);
+  }
+  sema = mss_sema_create(1);
+  mque = mss_mque_create(BENCH_TASK_ID);
+  mem = mss_mem_create(sizeof(uint16_t), BENCH_MAX_N + 1);
+
+  mss_bench_result.num_of_ops = BENCH_NUM_OF_OPS;
+  mss_bench_result.num_of_n = BENCH_NUM_OF_N;
+
+  for(i=0 ; i<BENCH_NUM_OF_N ; i++)
+  {
+    mss_bench_result.n[i] = bench_n[i];
+
+    bench_activate(i);
+    bench_timer(i);
+    bench_sema(i, sema);
+    bench_mque(i, mque);
+    bench_mem(i, mem);
+    bench_auth(i);
+  }
+
+  mss_bench_done();
+
+  while(1);
+}
+
+/**************************************************************************//**
+*
+* mss_bench_done
+*
+* @brief      end of the benchmarks, breakpoint of the runner
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_bench_done(void)
+{
+  __no_operation();
+}
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* bench_put
+*
+* @brief      store the average of one measurement
+*
+* @param[in]  op       BENCH_OP_xxx
+* @param[in]  n_idx    index of the live object count
+* @param[in]  sum      cycles of BENCH_REPS repetitions
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_put(uint8_t op, uint8_t n_idx, uint16_t sum)
+{
+  sum /= BENCH_REPS;
+
+  mss_bench_result.cycles[op][n_idx] =
+    (sum > bench_overhead) ? (sum - bench_overhead) : 0;
+}
+
+/**************************************************************************//**
+*
+* bench_activate
+*
+* @brief      mss_activate_task with n ready tasks
+*
+* @param[in]  n_idx    index of the live object count
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_activate(uint8_t n_idx)
+{
+  uint16_t sum = 0;
+  uint8_t i, j;
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    // the scheduler does not run, clear the ready tasks directly
+    mss_ready_task_bits = 0;
+    for(j=0 ; j<bench_n[n_idx] ; j++)
+    {
+      mss_activate_task(j);
+    }
+
+    BENCH_START();
+    mss_activate_task(BENCH_TASK_ID);
+    BENCH_STOP(sum);
+  }
+  mss_ready_task_bits = 0;
+
+  bench_put(BENCH_OP_ACTIVATE, n_idx, sum);
+}
+
+/**************************************************************************//**
+*
+* bench_timer
+*
+* @brief      mss_timer_start and mss_timer_stop with n running timers
+*
+* @param[in]  n_idx    index of the live object count
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_timer(uint8_t n_idx)
+{
+  uint16_t start_sum = 0, stop_sum = 0;
+  uint8_t n = bench_n[n_idx];
+  uint8_t i;
+
+  for(i=0 ; i<n ; i++)
+  {
+    mss_timer_start(timer[i], 100 + i);
+  }
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    BENCH_START();
+    mss_timer_start(timer[n], BENCH_TIMEOUT);
+    BENCH_STOP(start_sum);
+
+    BENCH_START();
+    mss_timer_stop(timer[n]);
+    BENCH_STOP(stop_sum);
+  }
+
+  for(i=0 ; i<n ; i++)
+  {
+    mss_timer_stop(timer[i]);
+  }
+
+  bench_put(BENCH_OP_TIMER_START, n_idx, start_sum);
+  bench_put(BENCH_OP_TIMER_STOP, n_idx, stop_sum);
+}
+
+/**************************************************************************//**
+*
+* bench_sema
+*
+* @brief      mss_sema_post and mss_sema_wait of the holding task with n
+*             waiting tasks
+*
+* @param[in]  n_idx    index of the live object count
+* @param[in]  sema     semaphore with the value 1
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_sema(uint8_t n_idx, mss_sema_t sema)
+{
+  uint16_t wait_sum = 0, post_sum = 0;
+  uint8_t n = bench_n[n_idx];
+  uint8_t i;
+
+  // the scheduler does not run, act as the holding and the waiting tasks
+  mss_running_task_id = BENCH_TASK_ID;
+  mss_sema_wait(sema);
+  for(i=0 ; i<n ; i++)
+  {
+    mss_running_task_id = i;
+    mss_sema_wait(sema);
+  }
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    mss_running_task_id = BENCH_TASK_ID;
+
+    // wakes up task 0 (highest priority) if n > 0
+    BENCH_START();
+    mss_sema_post(sema);
+    BENCH_STOP(post_sum);
+
+    BENCH_START();
+    mss_sema_wait(sema);
+    BENCH_STOP(wait_sum);
+
+    if(n > 0)
+    {
+      // task 0 waits again
+      mss_running_task_id = 0;
+      mss_sema_wait(sema);
+    }
+  }
+
+  // release the semaphore, every post wakes up the next waiting task
+  mss_running_task_id = BENCH_TASK_ID;
+  mss_sema_post(sema);
+  for(i=0 ; i<n ; i++)
+  {
+    mss_running_task_id = i;
+    if(mss_sema_wait(sema))
+    {
+      mss_sema_post(sema);
+    }
+  }
+  mss_running_task_id = MSS_INVALID_TASK_ID;
+  mss_ready_task_bits = 0;
+
+  bench_put(BENCH_OP_SEMA_WAIT, n_idx, wait_sum);
+  bench_put(BENCH_OP_SEMA_POST, n_idx, post_sum);
+}
+
+/**************************************************************************//**
+*
+* bench_mque
+*
+* @brief      mss_mque_send and mss_mque_read with n queued messages
+*
+* @param[in]  n_idx    index of the live object count
+* @param[in]  mque     empty message queue
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_mque(uint8_t n_idx, mss_mque_t mque)
+{
+  uint16_t send_sum = 0, read_sum = 0;
+  uint8_t n = bench_n[n_idx];
+  mss_mque_msg_t* next = &msg[n];
+  uint8_t i;
+
+  for(i=0 ; i<n ; i++)
+  {
+    mss_mque_send(mque, &msg[i]);
+  }
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    BENCH_START();
+    mss_mque_send(mque, next);
+    BENCH_STOP(send_sum);
+
+    // the oldest message is sent again in the next repetition
+    BENCH_START();
+    next = mss_mque_read(mque);
+    BENCH_STOP(read_sum);
+  }
+
+  while(mss_mque_read(mque) != NULL);
+  mss_ready_task_bits = 0;
+
+  bench_put(BENCH_OP_MQUE_SEND, n_idx, send_sum);
+  bench_put(BENCH_OP_MQUE_READ, n_idx, read_sum);
+}
+
+/**************************************************************************//**
+*
+* bench_mem
+*
+* @brief      mss_mem_alloc and mss_mem_free with n allocated blocks
+*
+* @param[in]  n_idx    index of the live object count
+* @param[in]  mem      memory block pool without allocated blocks
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_mem(uint8_t n_idx, mss_mem_t mem)
+{
+  uint16_t alloc_sum = 0, free_sum = 0;
+  uint8_t n = bench_n[n_idx];
+  uint8_t i;
+
+  for(i=0 ; i<n ; i++)
+  {
+    block[i] = mss_mem_alloc(mem);
+  }
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    BENCH_START();
+    block[n] = mss_mem_alloc(mem);
+    BENCH_STOP(alloc_sum);
+
+    BENCH_START();
+    mss_mem_free(mem, block[n]);
+    BENCH_STOP(free_sum);
+  }
+
+  for(i=0 ; i<n ; i++)
+  {
+    mss_mem_free(mem, block[i]);
+  }
+
+  bench_put(BENCH_OP_MEM_ALLOC, n_idx, alloc_sum);
+  bench_put(BENCH_OP_MEM_FREE, n_idx, free_sum);
+}
+
+/**************************************************************************//**
+*
+* bench_auth
+*
+* @brief      AuthMac of n message bytes and AuthCheck of a lock command
+*             with the administrator key (key read from information memory,
+*             MAC of nonce and opcode, tag comparison), the nonce seed is
+*             not drawn (no VLO in the simulator) and the key store is not
+*             probed (administrator id)
+*
+* @param[in]  n_idx    index of the message length
+*
+* @return     -
+*
+******************************************************************************/
+static void bench_auth(uint8_t n_idx)
+{
+  uint16_t mac_sum = 0, check_sum = 0;
+  uint8_t i;
+
+  auth_cred[0] = (INT8U)CRED_ADMIN_ID;
+  auth_cred[1] = (INT8U)(CRED_ADMIN_ID >> 8);
+
+  for(i=0 ; i<BENCH_REPS ; i++)
+  {
+    BENCH_START();
+    AuthMac(auth_key, auth_msg, bench_n[n_idx], &auth_cred[CRED_ID_LEN]);
+    BENCH_STOP(mac_sum);
+
+    BENCH_START();
+    AuthCheck(LOCK_CMD_CH, auth_msg, 0, auth_cred);
+    BENCH_STOP(check_sum);
+  }
+
+  bench_put(BENCH_OP_AUTH_MAC, n_idx, mac_sum);
+  bench_put(BENCH_OP_AUTH_CHECK, n_idx, check_sum);
+}
+
+#endif /* defined(MSS_CYCLE_BENCH) */
@@ -1,5 +1,7 @@
-// MSP430 Library
+// MSP430 Library (not in the host simulation, see host/fleet)
+#if !defined(MSS_HAL_POSIX) && !defined(MSS_HAL_SIM)
 #include <msp430.h>
+#endif
 
 // Data types
 typedef unsigned char  INT8U;
@@ -11,17 +13,37 @@ typedef signed   long  INT32S;
 
 // MSS Tasks
 extern void ControlTask(void *param);
+extern void InitControlTasks(void);
 
 // Task ID's
 #define CNTL_TSK_ID                     (0)
 
+// Latency measurement interrupt sources (MSS_LATENCY_STATS)
+#define LAT_SRC_UART                    (0)
+#define LAT_SRC_PORT1                   (1)
+#define LAT_SRC_PORT2                   (2)
+
 // Default Task Frequencies & Macros
 #define CNTL_TSK_FREQ                 (100)
-#define CH_MOTOR_STATE               (1500)
-#define SECURITY_KEY           ("1X5u!j8*")
-#define KEY_LEN                         (8)
-#define RX_BUFFER_LEN				   (10)
+// Frame commands (opcode, arguments) and replies (opcode, result)
+#define LOCK_CMD_CH                   ('l')   // key id, tag
+#define UNLOCK_CMD_CH                 ('u')   // key id, tag
+#define CHALLENGE_CH                  ('c')   // reply: nonce[AUTH_NONCE_LEN]
+#define ENROLL_CMD_CH                 ('e')   // new id, key, admin key id, tag
+#define REVOKE_CMD_CH                 ('r')   // id, admin key id, tag
 #define STATE_CHECK_CH                ('~')
+#define STATS_DUMP_CH                 ('#')
+#define TRACE_DUMP_CH                 ('$')
+#define LATENCY_DUMP_CH               ('%')
+#define AUDIT_DUMP_CH                 ('&')   // admin key id, tag; burst
+#define MOTOR_REPORT_CH               ('*')   // reply: see MotorReport
+#define STATE_LOCKED_CH               ('l')
+#define STATE_UNLOCKED_CH             ('u')
+#define DENIED_CH                     ('!')   // unknown key, wrong tag
+#define INVALID_CH                    ('?')   // unknown, truncated, failed
+#define DONE_CH                       ('.')
+#define MOTOR_STALL_CH                ('s')   // cut at the end stop
+#define MOTOR_TIMEOUT_CH              ('t')   // full enable time
 #define TRUE          	1
 #define FALSE			0
 #define TX_BUFF_READY 	IFG2&UCA0TXIFG
@@ -60,7 +60,10 @@ MEMORY
     INFOB                   : origin = 0x1080, length = 0x0040
     INFOC                   : origin = 0x1040, length = 0x0040
     INFOD                   : origin = 0x1000, length = 0x0040
-    FLASH                   : origin = 0xC000, length = 0x3FE0
+    FLASH                   : origin = 0xC000, length = 0x2C00
+    KEYS                    : origin = 0xEC00, length = 0x0400  /* KeyStore.h */
+    EPOCH                   : origin = 0xF000, length = 0x0400  /* Auth.c */
+    AUDIT                   : origin = 0xF400, length = 0x0A00  /* Audit.h */
     INT00                   : origin = 0xFFE0, length = 0x0002
     INT01                   : origin = 0xFFE2, length = 0x0002
     INT02                   : origin = 0xFFE4, length = 0x0002
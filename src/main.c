@@ -4,31 +4,37 @@
 #include "includes.h"
 #include "UART.h"
 #include "Motor.h"
+#include "Frame.h"
 #include "mss/mss.h"
+#include "Auth.h"
+#include "Cred.h"
+#include "Flash.h"
+#include "Journal.h"
+#include "Audit.h"
+#include "Current.h"
 
 ////////////////////////////////////////////////////////////////////
 // FUNCTION PROTOTYPES                                            //
 ////////////////////////////////////////////////////////////////////
 void main(void);
 void ControlTask(void *param);
-static void InitControlTasks(void);
+void InitControlTasks(void);
+static INT8U StateCh(void);
 
 ////////////////////////////////////////////////////////////////////
 // TASK INSTANCES - Task State & Task Control Timer.              //
 ////////////////////////////////////////////////////////////////////
-struct TaskInstance ControlTaskInst = {MSS_TASK_CTX_STATE_INIT_VAL, MSS_TIMER_INVALID_HDL};
-
-////////////////////////////////////////////////////////////////////
-// TASK INSTANCES - Task State & Task Control Timer.              //
-////////////////////////////////////////////////////////////////////
-typedef enum {
-	INVALID,
-	VALID
-} SECURITY_STATE;
-LockState LockState = INIT;
-INT8U SendKey = FALSE;
+LOCK_STATE LockState = INIT;
+INT8U SendNonce = FALSE;
 INT8U Manual = FALSE;
-INT8U SecurityKeyStr[] = "1X5u!j8*";
+
+// ControlTask state kept while it waits for the OS
+static INT8U *cmd;                      // next command of the frame
+static INT8U cmd_left;                  // frame bytes left from cmd on
+static INT8U reply[FRAME_MAX_PAYLOAD];
+static INT8U reply_len;
+
+#if !defined(MSS_HAL_SIM)
 
 ////////////////////////////////////////////////////////////////////
 // main       - Instantiates modules and OS                       //
@@ -38,10 +44,21 @@ INT8U SecurityKeyStr[] = "1X5u!j8*";
 void main(void) {
 	WATCHDOG_STOP;							// Stop watchdog timer
 
-	// Instantiate UART, Motor, and OS
+	// Instantiate UART, Frame receiver, OS, Flash, Credentials, Lock
+	// state journal, Audit log, Authentication, Motor and current
+	// sense. The OS sets up the calibrated clocks and the shared
+	// Timer0_A, which the later modules use: the flash timing
+	// generator runs from SMCLK, the first erase may be in CredInit
 	UARTInit();
-	MotorInit();
+	FrameInit();
 	mss_init();
+	FlashInit();
+	CredInit();
+	JournalInit();
+	AuditInit();
+	AuthInit();
+	MotorInit();
+	CurrentInit();
 
 	// Key code push button code
 	P1DIR &= ~0x80; // Input P1.7
@@ -60,140 +77,255 @@ void main(void) {
     // Enable low power mode with interrupts
     LOW_POWER_ISR;
 }
+#endif
 
 ////////////////////////////////////////////////////////////////////
-// ControlTask - Checks for new user input and toggles motor      //
+// StateCh    - Returns the reply character of the lock state     //
+// Parameters - None                                              //
+// Return     - INT8U: STATE_LOCKED_CH or STATE_UNLOCKED_CH       //
+////////////////////////////////////////////////////////////////////
+static INT8U StateCh(void) {
+	return (LockState == LOCKED) ? STATE_LOCKED_CH : STATE_UNLOCKED_CH;
+}
+
+////////////////////////////////////////////////////////////////////
+// ControlTask - Dispatches the commands of received frames and   //
+//               queues motor moves. Runs when activated by a     //
+//               frame, a button, its timer or the motor.         //
 // Parameters  - void *param: Optional parameter (unused)	      //
 // Return     - None											  //
 ////////////////////////////////////////////////////////////////////
 void ControlTask(void *param) {
-	MSS_BEGIN(ControlTaskInst.State);
+	INT8U op;
+	INT8U arg_len;
 
-	// Incoming character & lock state
-	static INT8U ch;
-	static INT8U rx_buffer[RX_BUFFER_LEN];
-	static INT8U buffer_index = 0;
-	static INT8U last_char = 0x00;
-	SECURITY_STATE security_state = INVALID;
-	INT8U cmp_index;
+	MSS_BEGIN(MSS_TASK_CTX);
 
     FOREVER() {
-    	ch = UARTGetChar();
-
-    	// Store char in buffer
-    	if (ch != last_char) {
-    		rx_buffer[buffer_index] = ch;
-
-    		// Send back current state
-    		if (ch == STATE_CHECK_CH) {
-    			if (LockState == LOCKED) {
-    				UARTPutChar('l');
-    			} else if (LockState == UNLOCKED || LockState == INIT) {
-    				UARTPutChar('u');
-    			} else {}
-    			// reset index
-    			buffer_index = 0;
+    	// Queued moves have ended: report the outcome of each, the lock
+    	// state already changed when it was queued
+    	if ((mss_event_get() & MOTOR_EVENT_DONE) != 0) {
+    		reply[0] = MOTOR_REPORT_CH;
+    		while (MotorDone(&reply[1]) == TRUE) {
+    			FrameSend(reply, MOTOR_REPORT_LEN+1);
     		}
+    	}
+
+    	// Dispatch all commands of a received frame in one go, one
+    	// opcode + result pair per command in the reply frame
+    	cmd_left = FrameGet(&cmd);
+    	reply_len = 0;
 
-    		// Buffer full
-    		if (buffer_index == RX_BUFFER_LEN-1) {
-    			security_state = VALID;
+    	while (cmd_left > 0 && reply_len < FRAME_MAX_PAYLOAD-1) {
+    		op = cmd[0];
+    		reply[reply_len++] = op;
 
-    			// Validate key
-    			for (cmp_index = 0; cmp_index < KEY_LEN; cmp_index++) {
-    				if (rx_buffer[cmp_index] != SECURITY_KEY[cmp_index]) {
-    					security_state = INVALID;
+    		// Authenticated lock and unlock, reply the new state
+    		if (op == LOCK_CMD_CH || op == UNLOCK_CMD_CH) {
+    			if (cmd_left <= AUTH_CRED_LEN) {
+    				reply[reply_len++] = INVALID_CH;
+    				break;
+    			}
+    			if (AuthCheck(op, cmd, 0, &cmd[1]) == FALSE) {
+    				AuditLog(AUDIT_DENIED, CRED_ID(&cmd[1]));
+    				reply[reply_len++] = DENIED_CH;
+    			} else if (op == LOCK_CMD_CH && LockState != LOCKED) {
+    				// The move is queued, the reply does not wait for it.
+    				// The new state is journaled now (see Journal.h).
+    				if (MotorOut() == TRUE) {
+    					LockState = LOCKED;
+    					JournalWrite(LOCKED);
+    					AuditLog(AUDIT_LOCK, CRED_ID(&cmd[1]));
+    					reply[reply_len++] = StateCh();
+    				} else {
+    					reply[reply_len++] = INVALID_CH;
+    				}
+    			} else if (op == UNLOCK_CMD_CH && LockState == LOCKED) {
+    				if (MotorIn() == TRUE) {
+    					LockState = UNLOCKED;
+    					JournalWrite(UNLOCKED);
+    					AuditLog(AUDIT_UNLOCK, CRED_ID(&cmd[1]));
+    					reply[reply_len++] = StateCh();
+    				} else {
+    					reply[reply_len++] = INVALID_CH;
     				}
+    			} else {
+    				reply[reply_len++] = StateCh();
+    			}
+    			cmd += AUTH_CRED_LEN;
+    			cmd_left -= AUTH_CRED_LEN;
+    		}
+    		// Enrollment and revocation of a key id, authenticated by
+    		// the administrator key, no reflash needed. An enrollment
+    		// carries the new key, encrypted (Auth.h).
+    		else if (op == ENROLL_CMD_CH || op == REVOKE_CMD_CH) {
+    			arg_len = (op == ENROLL_CMD_CH) ? CRED_ID_LEN + AUTH_KEY_LEN
+    			                                : CRED_ID_LEN;
+    			if (cmd_left <= arg_len + AUTH_CRED_LEN) {
+    				reply[reply_len++] = INVALID_CH;
+    				break;
+    			}
+    			if (AuthCheck(op, &cmd[1], arg_len, &cmd[1 + arg_len]) == FALSE
+    			    || CRED_ID(&cmd[1 + arg_len]) != CRED_ADMIN_ID) {
+    				AuditLog(AUDIT_DENIED, CRED_ID(&cmd[1 + arg_len]));
+    				reply[reply_len++] = DENIED_CH;
+    			} else if (op == ENROLL_CMD_CH
+    			           && CredEnroll(CRED_ID(&cmd[1]),
+    			                         &cmd[1 + CRED_ID_LEN]) == TRUE) {
+    				AuditLog(AUDIT_ENROLL, CRED_ID(&cmd[1]));
+    				reply[reply_len++] = DONE_CH;
+    			} else if (op == REVOKE_CMD_CH
+    			           && CredRevoke(CRED_ID(&cmd[1])) == TRUE) {
+    				AuditLog(AUDIT_REVOKE, CRED_ID(&cmd[1]));
+    				reply[reply_len++] = DONE_CH;
+    			} else {
+    				reply[reply_len++] = INVALID_CH;
+    			}
+    			cmd += arg_len + AUTH_CRED_LEN;
+    			cmd_left -= arg_len + AUTH_CRED_LEN;
+    		}
+    		// Nonce for the next authenticated command
+    		else if (op == CHALLENGE_CH) {
+    			if (reply_len + AUTH_NONCE_LEN > FRAME_MAX_PAYLOAD) {
+    				reply[reply_len++] = INVALID_CH;
+    				break;
     			}
+    			AuthGetNonce(&reply[reply_len]);
+    			reply_len += AUTH_NONCE_LEN;
+    		}
+    		else if (op == STATE_CHECK_CH) {
+    			reply[reply_len++] = StateCh();
+    		}
+    		// Outcome of the last motor actuation
+    		else if (op == MOTOR_REPORT_CH) {
+    			if (reply_len + MOTOR_REPORT_LEN > FRAME_MAX_PAYLOAD) {
+    				reply[reply_len++] = INVALID_CH;
+    				break;
+    			}
+    			MotorReport(&reply[reply_len]);
+    			reply_len += MOTOR_REPORT_LEN;
+    		}
+    		// Export the audit log in one burst, authenticated by the
+    		// administrator key
+    		else if (op == AUDIT_DUMP_CH) {
+    			if (cmd_left <= AUTH_CRED_LEN) {
+    				reply[reply_len++] = INVALID_CH;
+    				break;
+    			}
+    			if (AuthCheck(op, cmd, 0, &cmd[1]) == FALSE
+    			    || CRED_ID(&cmd[1]) != CRED_ADMIN_ID) {
+    				AuditLog(AUDIT_DENIED, CRED_ID(&cmd[1]));
+    				reply[reply_len++] = DENIED_CH;
+    			} else {
+    				AuditExport();
+    				reply[reply_len++] = DONE_CH;
+    			}
+    			cmd += AUTH_CRED_LEN;
+    			cmd_left -= AUTH_CRED_LEN;
+    		}
+#if (MSS_TASK_STATS == TRUE)
+    		// Dump per-task CPU time statistics
+    		else if (op == STATS_DUMP_CH) {
+    			UARTPutTaskStats();
+    			reply[reply_len++] = DONE_CH;
+    		}
+#endif
+#if (MSS_TRACE == TRUE)
+    		// Dump scheduler trace records
+    		else if (op == TRACE_DUMP_CH) {
+    			UARTPutTrace();
+    			reply[reply_len++] = DONE_CH;
+    		}
+#endif
+#if (MSS_LATENCY_STATS == TRUE)
+    		// Dump ISR-to-task latency statistics
+    		else if (op == LATENCY_DUMP_CH) {
+    			UARTPutLatency();
+    			reply[reply_len++] = DONE_CH;
+    		}
+#endif
+    		else {
+    			reply[reply_len++] = INVALID_CH;
+    			break;
+    		}
 
-    			// Lock and Unlock States
-    			if (rx_buffer[buffer_index] == 'l' 
-					&& (LockState == UNLOCKED || LockState == INIT) 
-					&& security_state == VALID
-				) {
-    				MotorOut();
-    				MotorEnable2s();
-    				UARTPutChar(ch);
-    				LockState = LOCKED;
-    				// State change: 1.5 seconds delay
-    				MSS_TIMER_DELAY_MS(
-						ControlTaskInst.Timer, CH_MOTOR_STATE, ControlTaskInst.State
-					);
-    			} else if (rx_buffer[buffer_index] == 'u' && LockState == LOCKED 
-					&& security_state == VALID
-				) {
-    			    MotorIn();
-    				MotorEnable2s();
-    				UARTPutChar(ch);
-    				LockState = UNLOCKED;
-    				// State change: 1.5 seconds delay
-    				MSS_TIMER_DELAY_MS(
-						ControlTaskInst.Timer, CH_MOTOR_STATE+50, ControlTaskInst.State
-					);
-    			} else {}
-    			buffer_index = 0;
-    			last_char = ch;
-    		} else if (ch != STATE_CHECK_CH) {
-    			buffer_index++;
-    		} else {}
-    		last_char = ch;
+    		cmd++;
+    		cmd_left--;
     	}
-		
-		// Pairing button pressed.
-    	if (SendKey == TRUE) {
-    		UARTPutChar('s');
-    		for (cmp_index = 0; cmp_index < RX_BUFFER_LEN-1; cmp_index++) {
-    			MSS_TIMER_DELAY_MS(
-					ControlTaskInst.Timer, CNTL_TSK_FREQ-25, ControlTaskInst.State
-				);
-    			UARTPutChar(SecurityKeyStr[i]);
-    		}
-			MSS_TIMER_DELAY_MS(ControlTaskInst.Timer, CNTL_TSK_FREQ, ControlTaskInst.State);
-			SendKey = FALSE;
-			buffer_index = 0;
+
+    	if (reply_len > 0) {
+    		FrameSend(reply, reply_len);
+    		FrameRelease();
+    	}
+
+		// Pairing button pressed: offer a challenge, the key itself
+		// never leaves the lock
+    	if (SendNonce == TRUE) {
+    		reply[0] = CHALLENGE_CH;
+    		AuthGetNonce(&reply[1]);
+    		FrameSend(reply, AUTH_NONCE_LEN+1);
+			MSS_TIMER_DELAY_MS(MSS_TASK_TIMER, CNTL_TSK_FREQ, MSS_TASK_CTX);
+			SendNonce = FALSE;
 		}
-		
+
 		// Manual Override Activated
 		if (Manual == TRUE) {
-			if (LockState == LOCKED) {
-				MotorIn();
-				MotorEnable2s();
-				UARTPutChar('u');
+			if (LockState == LOCKED && MotorIn() == TRUE) {
 				LockState = UNLOCKED;
-			} else if (LockState == UNLOCKED) {
-				MotorOut();
-				MotorEnable2s();
-				UARTPutChar('l');
+			} else if (LockState == UNLOCKED && MotorOut() == TRUE) {
 				LockState = LOCKED;
 			} else {}
-			MSS_TIMER_DELAY_MS(ControlTaskInst.Timer, CNTL_TSK_FREQ, ControlTaskInst.State);
-			buffer_index = 0;
+			JournalWrite(LockState);
+			AuditLog(AUDIT_MANUAL, LockState);
+			reply[0] = STATE_CHECK_CH;
+			reply[1] = StateCh();
+			FrameSend(reply, 2);
+			MSS_TIMER_DELAY_MS(MSS_TASK_TIMER, CNTL_TSK_FREQ, MSS_TASK_CTX);
 			Manual = FALSE;
 		}
+
+		// Sleep until the next frame, button or timer activation
+		MSS_RETURN(MSS_TASK_CTX);
     }
 
 	MSS_FINISH();
 }
 
 ////////////////////////////////////////////////////////////////////
-// InitControlTasks - Starts ControlTask periodic timer.          //
+// InitControlTasks - Restores the lock state and registers       //
+//                    ControlTask with the OS.                    //
 // Parameters       - None	      								  //
 // Return           - None										  //
 ////////////////////////////////////////////////////////////////////
-static void InitControlTasks(void)
+void InitControlTasks(void)
 {
-    ControlTaskInst.Timer = mss_timer_create(CNTL_TSK_ID);
+    // Restore the journaled lock state without moving the motor, it is
+    // only homed when there is no state yet (first boot)
+    LockState = JournalState();
+    if (LockState == INIT) {
+        MotorHome();
+        LockState = UNLOCKED;
+        JournalWrite(UNLOCKED);
+    }
+    AuditLog(AUDIT_BOOT, LockState);
+
+    mss_task_create(CNTL_TSK_ID, ControlTask, NULL);
 }
 
+#if !defined(MSS_HAL_SIM)
+
 ////////////////////////////////////////////////////////////////////
-// Port_1     - Port 1 Interrupt to send key through UART.        //
+// Port_1     - Port 1 Interrupt to send a nonce through UART.    //
 // Parameters - None	      								      //
 // Return     - Interrupt										  //
 ////////////////////////////////////////////////////////////////////
 #pragma vector=PORT1_VECTOR
 __interrupt void Port_1 (void) {
-	SendKey = TRUE;
+	MSS_LATENCY_ISR_ENTRY(LAT_SRC_PORT1, CNTL_TSK_ID);
+	SendNonce = TRUE;
 	P1IFG &= ~0x80;
+	mss_activate_task(CNTL_TSK_ID);
+	MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_PORT);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -203,7 +335,11 @@ __interrupt void Port_1 (void) {
 ////////////////////////////////////////////////////////////////////
 #pragma vector=PORT2_VECTOR
 __interrupt void Port_2 (void) {
+	MSS_LATENCY_ISR_ENTRY(LAT_SRC_PORT2, CNTL_TSK_ID);
 	Manual = TRUE;
 	P2IES ^= 0x10;
 	P2IFG &= ~0x10;
-}
\ No newline at end of file
+	mss_activate_task(CNTL_TSK_ID);
+	MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_PORT);
+}
+#endif
@@ -48,7 +48,9 @@
 //*****************************************************************************
 
 // include stdint.h and stbool.h if available
+#if !defined(MSS_HAL_POSIX) && !defined(MSS_HAL_SIM)
 #include <msp430.h>
+#endif
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -262,6 +262,52 @@ void llist_remove(llist_t hdl, void* object)
   }
 }
 
+/**************************************************************************//**
+*
+* llist_insert
+*
+* @brief      insert an object into a sorted linked list, in front of the
+*             first object which is not less than it. Only the objects up to
+*             the insert position are compared.
+*
+* @param[in]  hdl        handle of the linked list
+*
+* @param[in]  object     pointer object to be added into the linked list
+*
+* @param[in]  comp_func  pointer to callback function for comparing two objects
+*                        (see @ref llist_sort)
+*
+* @return     -
+*
+******************************************************************************/
+void llist_insert(llist_t hdl, void* object, int8_t (*comp_func)(void*, void*))
+{
+  void *cur_obj, *prev_obj = NULL;
+
+  // check parameters
+  LLIST_ASSERT((hdl != LLIST_INVALID_HDL) && (object != NULL) &&
+               (comp_func != NULL));
+
+  // skip the objects which are less than the new one
+  for(cur_obj = hdl->first ;
+      (cur_obj != NULL) && (comp_func(object, cur_obj) > 0) ;
+      cur_obj = ((llist_hdr_t*)cur_obj)->next)
+  {
+    prev_obj = cur_obj;
+  }
+
+  // link the object in front of the current one
+  ((llist_hdr_t*)object)->next = cur_obj;
+  if(prev_obj != NULL)
+  {
+    ((llist_hdr_t*)prev_obj)->next = object;
+  }
+  else
+  {
+    hdl->first = object;
+  }
+}
+
 /**************************************************************************//**
 *
 * llist_sort
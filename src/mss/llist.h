@@ -200,6 +200,26 @@ void* llist_get_first(llist_t hdl);
 ******************************************************************************/
 void llist_remove(llist_t hdl, void* object);
 
+/**************************************************************************//**
+*
+* llist_insert
+*
+* @brief      insert an object into a sorted linked list, in front of the
+*             first object which is not less than it. Only the objects up to
+*             the insert position are compared.
+*
+* @param[in]  hdl        handle of the linked list
+*
+* @param[in]  object     pointer object to be added into the linked list
+*
+* @param[in]  comp_func  pointer to callback function for comparing two objects
+*                        (see @ref llist_sort)
+*
+* @return     -
+*
+******************************************************************************/
+void llist_insert(llist_t hdl, void* object, int8_t (*comp_func)(void*, void*));
+
 /**************************************************************************//**
 *
 * llist_sort
@@ -44,7 +44,6 @@
 // Include section
 //*****************************************************************************
 
-#include "../includes.h"
 #include "mss.h"
 #include "mss_int.h"
 
@@ -65,7 +64,7 @@ mss_task_bits_t mss_task_reactivated = 0;
 /** mss_ready_task_bits
  *  flag bits indicating whether the mss task is in ready/idle state
  */
-mss_task_bits_t mss_ready_task_bits = MSS_READY_TASK_BITS_INIT;
+mss_task_bits_t mss_ready_task_bits = 0;
 
 /** mss_bitpos_to_bit
  *  table for converting bit position to mss_task_bits_t bit value
@@ -89,17 +88,109 @@ mss_task_bits_t mss_task_preempted = 0;
 typedef struct {
   mss_task_t task;
   void* param;
+  mss_task_ctx_t ctx;
+#if (MSS_TASK_USE_TIMER == TRUE)
+  mss_timer_t timer;
+#endif
 } mss_task_list_entry_t;
 
 /** mss_task_list
- *  list of mss tasks
+ *  list of mss tasks, filled by mss_task_create
+ */
+static mss_task_list_entry_t mss_task_list[MSS_NUM_OF_TASKS];
+
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+/** MSS_NUM_OF_PRIO_LEVELS
+ *  number of priority levels
+ */
+#define MSS_NUM_OF_PRIO_LEVELS                                                \
+        ((MSS_NUM_OF_TASKS + MSS_TASKS_PER_PRIO_LEVEL - 1) /                  \
+         MSS_TASKS_PER_PRIO_LEVEL)
+
+/** MSS_PRIO_LEVEL_BITS
+ *  task bits of all tasks in the priority level of a task id
+ */
+#define MSS_PRIO_LEVEL_BITS(task_id)                                          \
+        ((mss_task_bits_t)(((mss_task_bits_t)-1) >>                           \
+         ((sizeof(mss_task_bits_t)*8) - MSS_TASKS_PER_PRIO_LEVEL))            \
+         << MSS_PRIO_LEVEL_FIRST_TASK(task_id))
+
+/** rr_done_bits
+ *  per priority level, bits of the tasks up to (and including) the task
+ *  executed last - the round-robin continues after these
+ */
+static mss_task_bits_t rr_done_bits[MSS_NUM_OF_PRIO_LEVELS];
+#endif /* (MSS_TASKS_PER_PRIO_LEVEL > 1) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+/** EDF_NOT_IN_HEAP
+ *  heap position of a task which is not ready
  */
-static mss_task_list_entry_t mss_task_list[MSS_NUM_OF_TASKS] = MSS_TASK_LIST;
+#define EDF_NOT_IN_HEAP          (0xFF)
+
+/** EDF_TICK_BEFORE
+ *  true if timer tick a is before timer tick b (wrap-around safe as long as
+ *  both are within half of the timer tick range)
+ */
+#define EDF_TICK_BEFORE(a, b)                                                 \
+        ((mss_timer_tick_t)((a) - (b)) &                                      \
+         (mss_timer_tick_t)(1UL << ((sizeof(mss_timer_tick_t)*8) - 1)))
+
+// relative deadline of each task
+static mss_timer_tick_t edf_rel_deadline[MSS_NUM_OF_TASKS];
+
+// absolute deadline of the current job of each task
+static mss_timer_tick_t edf_abs_deadline[MSS_NUM_OF_TASKS];
+
+// tasks whose current job has a deadline, fixed at the start of the job so
+// that mss_task_set_deadline does not change the order of the heap
+static mss_task_bits_t edf_job_deadline_bits = 0;
+
+// deadline miss counter of each task
+static uint16_t edf_miss_cnt[MSS_NUM_OF_TASKS];
+
+// binary min-heap of ready task ids ordered by absolute deadline
+static uint8_t edf_heap[MSS_NUM_OF_TASKS];
+
+// position of each task in the heap
+static uint8_t edf_heap_pos[MSS_NUM_OF_TASKS];
+
+// number of tasks in the heap
+static uint8_t edf_heap_size = 0;
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
+#if (MSS_TASK_STATS == TRUE)
+// run time and activation statistics of each task
+static mss_task_stats_t task_stats[MSS_NUM_OF_TASKS];
+
+// sum of the measured time of all task invocations, used to take the time
+// of preempting tasks out of the run time of the preempted task
+static uint16_t stats_measured_time = 0;
+#endif /* (MSS_TASK_STATS == TRUE) */
 
 //*****************************************************************************
 // Internal function declarations
 //*****************************************************************************
 
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+static uint8_t rr_get_next_task(mss_task_bits_t ready_bits);
+#endif /* (MSS_TASKS_PER_PRIO_LEVEL > 1) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+static bool edf_before(uint8_t a, uint8_t b);
+static void edf_job_start(uint8_t task_id);
+static void edf_job_finish(uint8_t task_id);
+static void edf_heap_swap(uint8_t pos_a, uint8_t pos_b);
+static void edf_heap_sift_up(uint8_t pos);
+static void edf_heap_sift_down(uint8_t pos);
+static void edf_heap_remove(uint8_t task_id);
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
+#if ((MSS_TASK_STATS == TRUE) || (MSS_TRACE == TRUE)) && \
+    (MSS_EDF_SCHEDULING == FALSE)
+static void record_activations(mss_task_bits_t activated,
+                               mss_task_bits_t reactivated);
+#endif
 
 //*****************************************************************************
 // External functions
@@ -119,6 +210,27 @@ static mss_task_list_entry_t mss_task_list[MSS_NUM_OF_TASKS] = MSS_TASK_LIST;
 ******************************************************************************/
 void mss_init(void)
 {
+  uint8_t i;
+
+  // initialize the task table
+  for(i=0 ; i<MSS_NUM_OF_TASKS ; i++)
+  {
+    mss_task_list[i].task = NULL;
+    mss_task_list[i].param = NULL;
+    mss_task_list[i].ctx = MSS_TASK_CTX_STATE_INIT_VAL;
+  #if (MSS_TASK_USE_TIMER == TRUE)
+    mss_task_list[i].timer = MSS_TIMER_INVALID_HDL;
+  #endif
+  #if (MSS_EDF_SCHEDULING == TRUE)
+    edf_rel_deadline[i] = MSS_EDF_NO_DEADLINE;
+    edf_miss_cnt[i] = 0;
+    edf_heap_pos[i] = EDF_NOT_IN_HEAP;
+  #endif
+  #if (MSS_TASK_STATS == TRUE)
+    memset(&task_stats[i], 0, sizeof(mss_task_stats_t));
+  #endif
+  }
+
   // initialize mss HAL module
   mss_hal_init();
 
@@ -131,6 +243,11 @@ void mss_init(void)
   // initialize MSS timer
   mss_timer_init();
 #endif
+
+#if (MSS_LATENCY_STATS == TRUE)
+  // initialize MSS latency measurement
+  mss_latency_init();
+#endif
 }
 
 /**************************************************************************//**
@@ -189,13 +306,22 @@ void mss_scheduler(void)
 {
   uint8_t highest_prio;
   mss_int_flag_t int_flag;
+#if (MSS_TASK_STATS == TRUE)
+  uint16_t start_time, measured_before, elapsed, run_time;
+#endif
 
   MSS_ENTER_CRITICAL_SECTION(int_flag);
 
   do
   {
     // get the highest priority task
+  #if (MSS_EDF_SCHEDULING == TRUE)
+    highest_prio = (edf_heap_size > 0) ? edf_heap[0] : MSS_INVALID_TASK_ID;
+  #elif (MSS_TASKS_PER_PRIO_LEVEL > 1)
+    highest_prio = rr_get_next_task(mss_ready_task_bits);
+  #else
     highest_prio = mss_get_highest_prio_task(mss_ready_task_bits);
+  #endif
 
     // set running task id
     mss_running_task_id = highest_prio;
@@ -210,8 +336,34 @@ void mss_scheduler(void)
     }
 #endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
 
-    if(highest_prio != MSS_INVALID_TASK_ID)
+    if((highest_prio != MSS_INVALID_TASK_ID) &&
+       (mss_task_list[highest_prio].task == NULL))
     {
+      // task slot has been emptied by mss_task_delete
+      mss_ready_task_bits &= ~mss_bitpos_to_bit[highest_prio];
+    #if (MSS_EDF_SCHEDULING == TRUE)
+      edf_heap_remove(highest_prio);
+    #endif
+    }
+    else if(highest_prio != MSS_INVALID_TASK_ID)
+    {
+    #if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+      // next round-robin turn in this level starts after this task
+      rr_done_bits[MSS_TASK_PRIO_LEVEL(highest_prio)] =
+        (mss_task_bits_t)((mss_bitpos_to_bit[highest_prio] << 1) - 1);
+    #endif
+
+    #if (MSS_TASK_STATS == TRUE)
+      measured_before = stats_measured_time;
+      start_time = mss_hal_get_timestamp();
+    #endif
+
+      MSS_TRACE_RECORD(MSS_TRACE_EV_START, highest_prio);
+
+    #if (MSS_LATENCY_STATS == TRUE)
+      mss_latency_task_start(highest_prio);
+    #endif
+
       MSS_LEAVE_CRITICAL_SECTION(int_flag);
 
       // execute task
@@ -219,6 +371,22 @@ void mss_scheduler(void)
 
       MSS_ENTER_CRITICAL_SECTION(int_flag);
 
+      MSS_TRACE_RECORD(MSS_TRACE_EV_YIELD, highest_prio);
+
+    #if (MSS_TASK_STATS == TRUE)
+      // the invocations measured in the meantime were preempting tasks
+      elapsed = mss_hal_get_timestamp() - start_time;
+      run_time = elapsed - (stats_measured_time - measured_before);
+      stats_measured_time = measured_before + elapsed;
+
+      task_stats[highest_prio].run_time += run_time;
+      task_stats[highest_prio].runs++;
+      if(run_time > task_stats[highest_prio].max_run_time)
+      {
+        task_stats[highest_prio].max_run_time = run_time;
+      }
+    #endif /* (MSS_TASK_STATS == TRUE) */
+
       // set running task id to none
       mss_running_task_id = MSS_INVALID_TASK_ID;
 
@@ -232,11 +400,22 @@ void mss_scheduler(void)
       {
         // clear flag
         mss_task_reactivated &= ~mss_bitpos_to_bit[highest_prio];
+
+      #if (MSS_EDF_SCHEDULING == TRUE)
+        // the reactivation starts the next job of the task
+        edf_job_finish(highest_prio);
+        edf_job_start(highest_prio);
+      #endif
       }
       else
       {
         // clear ready bit of the task
         mss_ready_task_bits &= ~mss_bitpos_to_bit[highest_prio];
+
+      #if (MSS_EDF_SCHEDULING == TRUE)
+        edf_job_finish(highest_prio);
+        edf_heap_remove(highest_prio);
+      #endif
       }
     }
   }while(highest_prio != MSS_INVALID_TASK_ID);
@@ -293,16 +472,43 @@ void mss_activate_task_int(uint8_t task_id)
   {
   	// mark that the task shall be re-executed
     mss_task_reactivated |= mss_bitpos_to_bit[task_id];
+
+    MSS_TRACE_RECORD(MSS_TRACE_EV_REACTIVATE, task_id);
+
+  #if (MSS_TASK_STATS == TRUE)
+    task_stats[task_id].reactivations++;
+  #endif
   }
   else
   {
   	// mark that the new task shall be ready to be executed
     mss_ready_task_bits |= mss_bitpos_to_bit[task_id];
 
+    MSS_TRACE_RECORD(MSS_TRACE_EV_ACTIVATE, task_id);
+
+  #if (MSS_TASK_STATS == TRUE)
+    task_stats[task_id].activations++;
+  #endif
+
+  #if (MSS_EDF_SCHEDULING == TRUE)
+    if(edf_heap_pos[task_id] == EDF_NOT_IN_HEAP)
+    {
+      // new job, put the task into the deadline heap
+      edf_heap_pos[task_id] = edf_heap_size;
+      edf_heap[edf_heap_size++] = task_id;
+      edf_job_start(task_id);
+    }
+  #endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
   #if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
     if(mss_running_task_id != MSS_INVALID_TASK_ID)
     {
-      if(task_id < mss_running_task_id)
+    #if (MSS_EDF_SCHEDULING == TRUE)
+      if(edf_before(task_id, mss_running_task_id))
+    #else
+      if(MSS_TASK_PRIO_LEVEL(task_id) <
+         MSS_TASK_PRIO_LEVEL(mss_running_task_id))
+    #endif
       {
         // do the preemption, first set the preemption bit
         mss_task_preempted |= mss_bitpos_to_bit[mss_running_task_id];
@@ -317,6 +523,360 @@ void mss_activate_task_int(uint8_t task_id)
   }
 }
 
+/**************************************************************************//**
+*
+* mss_activate_tasks_int
+*
+* @brief      internal MSS function to put several tasks into active state
+*             with a single update of the ready bits - not reentrant
+*
+* @param[in]  task_bits    bits of the tasks to be activated
+*
+* @return     -
+*
+******************************************************************************/
+void mss_activate_tasks_int(mss_task_bits_t task_bits)
+{
+#if (MSS_EDF_SCHEDULING == TRUE)
+  uint8_t task_id;
+
+  // every task needs its own place in the deadline heap
+  while(task_bits)
+  {
+    task_id = mss_get_highest_prio_task(task_bits);
+    mss_activate_task_int(task_id);
+    task_bits &= ~mss_bitpos_to_bit[task_id];
+  }
+#else
+  mss_task_bits_t reactivated;
+
+  // running (or preempted) tasks only need to be re-executed
+  reactivated = 0;
+  if(mss_running_task_id != MSS_INVALID_TASK_ID)
+  {
+    reactivated = task_bits & mss_bitpos_to_bit[mss_running_task_id];
+  }
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+  reactivated |= task_bits & mss_task_preempted;
+#endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+  mss_task_reactivated |= reactivated;
+  task_bits &= ~reactivated;
+
+#if (MSS_TASK_STATS == TRUE) || (MSS_TRACE == TRUE)
+  record_activations(task_bits, reactivated);
+#endif
+
+  if(task_bits)
+  {
+    // mark that the new tasks shall be ready to be executed
+    mss_ready_task_bits |= task_bits;
+
+  #if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+    if(mss_running_task_id != MSS_INVALID_TASK_ID)
+    {
+      // any task below the priority level of the running task has
+      // higher priority
+      if(task_bits & (mss_bitpos_to_bit[
+           MSS_PRIO_LEVEL_FIRST_TASK(mss_running_task_id)] - 1))
+      {
+        // do the preemption, first set the preemption bit
+        mss_task_preempted |= mss_bitpos_to_bit[mss_running_task_id];
+      }
+
+      // don't call the scheduler directly, let the software interrupt
+      // does the job
+      mss_hal_trigger_sw_int();
+    }
+  #endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+  }
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+}
+
+/**************************************************************************//**
+*
+* mss_task_create
+*
+* @brief      register a task in the task table. The task id is the priority
+*             slot (lower id means higher priority) and the task is
+*             activated right away to run its initialization part
+*
+* @param[in]  prio      priority slot (0 .. MSS_NUM_OF_TASKS-1), or
+*                       MSS_TASK_PRIO_LOWEST_FREE to take the lowest priority
+*                       free slot
+* @param[in]  task      task function
+* @param[in]  param     parameter given to the task function (can be NULL)
+*
+* @return     task id of the created task, MSS_INVALID_TASK_ID if the slot
+*             is already taken or no slot is free
+*
+* @remark     shall be called after @ref mss_init
+*
+******************************************************************************/
+uint8_t mss_task_create(uint8_t prio, mss_task_t task, void* param)
+{
+  uint8_t task_id = MSS_INVALID_TASK_ID;
+  mss_int_flag_t int_flag;
+
+  // check parameters
+  MSS_DEBUG_CHECK(task != NULL);
+  MSS_DEBUG_CHECK((prio < MSS_NUM_OF_TASKS) ||
+                  (prio == MSS_TASK_PRIO_LOWEST_FREE));
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  if(prio == MSS_TASK_PRIO_LOWEST_FREE)
+  {
+    // search for the free slot with the lowest priority
+    for(prio=MSS_NUM_OF_TASKS ; prio>0 ; prio--)
+    {
+      if(mss_task_list[prio-1].task == NULL)
+      {
+        task_id = prio-1;
+        break;
+      }
+    }
+  }
+  else if(mss_task_list[prio].task == NULL)
+  {
+    task_id = prio;
+  }
+
+  if(task_id != MSS_INVALID_TASK_ID)
+  {
+    // fill the task slot
+    mss_task_list[task_id].task = task;
+    mss_task_list[task_id].param = param;
+    mss_task_list[task_id].ctx = MSS_TASK_CTX_STATE_INIT_VAL;
+
+  #if (MSS_TASK_STATS == TRUE)
+    // statistics start over with the new task in the slot
+    memset(&task_stats[task_id], 0, sizeof(mss_task_stats_t));
+  #endif
+
+  #if (MSS_TASK_USE_TIMER == TRUE)
+    // a slot keeps its timer, the owner task id never changes
+    if(mss_task_list[task_id].timer == MSS_TIMER_INVALID_HDL)
+    {
+      mss_task_list[task_id].timer = mss_timer_create(task_id);
+    }
+  #endif
+
+    // let the task run its initialization part
+    mss_activate_task_int(task_id);
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+  return task_id;
+}
+
+/**************************************************************************//**
+*
+* mss_task_delete
+*
+* @brief      remove a task from the task table. A task can delete itself,
+*             it will not be executed again after it returns
+*
+* @param[in]  task_id    task id number
+*
+* @return     true if success, false if the slot is empty or the task is
+*             currently preempted
+*
+******************************************************************************/
+bool mss_task_delete(uint8_t task_id)
+{
+  bool ret = false;
+  mss_task_bits_t task_bit;
+  mss_int_flag_t int_flag;
+
+  // check task id
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+
+  task_bit = mss_bitpos_to_bit[task_id];
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  if((mss_task_list[task_id].task != NULL)
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+      && (!(mss_task_preempted & task_bit))
+#endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+    )
+  {
+  #if (MSS_EDF_SCHEDULING == TRUE)
+    edf_heap_remove(task_id);
+  #endif
+
+    // empty the slot and drop any pending activation
+    mss_task_list[task_id].task = NULL;
+    mss_task_list[task_id].param = NULL;
+    mss_ready_task_bits &= ~task_bit;
+    mss_task_reactivated &= ~task_bit;
+
+  #if (MSS_TASK_USE_TIMER == TRUE)
+    if(mss_task_list[task_id].timer != MSS_TIMER_INVALID_HDL)
+    {
+      mss_timer_stop(mss_task_list[task_id].timer);
+    }
+  #endif
+
+    ret = true;
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+  return ret;
+}
+
+/**************************************************************************//**
+*
+* mss_task_get_ctx
+*
+* @brief      get the context of the running task (see @ref MSS_TASK_CTX)
+*
+* @param      -
+*
+* @return     pointer to the context of the running task
+*
+******************************************************************************/
+mss_task_ctx_t* mss_task_get_ctx(void)
+{
+  // check task id
+  MSS_DEBUG_CHECK(mss_running_task_id < MSS_NUM_OF_TASKS);
+
+  return &mss_task_list[mss_running_task_id].ctx;
+}
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+/**************************************************************************//**
+*
+* mss_task_get_timer
+*
+* @brief      get the timer of the running task (see @ref MSS_TASK_TIMER)
+*
+* @param      -
+*
+* @return     timer handle of the running task
+*
+******************************************************************************/
+mss_timer_t mss_task_get_timer(void)
+{
+  // check task id
+  MSS_DEBUG_CHECK(mss_running_task_id < MSS_NUM_OF_TASKS);
+
+  return mss_task_list[mss_running_task_id].timer;
+}
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+
+#if (MSS_TASK_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_task_get_stats
+*
+* @brief      get a copy of the run time and activation statistics of a task
+*
+* @param[in]  task_id    task id number
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_task_get_stats(uint8_t task_id, mss_task_stats_t* stats)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameters
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+  MSS_DEBUG_CHECK(stats != NULL);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  *stats = task_stats[task_id];
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_task_reset_stats
+*
+* @brief      clear the statistics of a task
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+******************************************************************************/
+void mss_task_reset_stats(uint8_t task_id)
+{
+  mss_int_flag_t int_flag;
+
+  // check task id
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  memset(&task_stats[task_id], 0, sizeof(mss_task_stats_t));
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+#endif /* (MSS_TASK_STATS == TRUE) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* mss_task_set_deadline
+*
+* @brief      set the relative deadline of a task for EDF scheduling. Every
+*             activation of the task starts a job whose absolute deadline is
+*             the activation tick plus the relative deadline
+*
+* @param[in]  task_id        task id number
+* @param[in]  rel_deadline   relative deadline in timer ticks, or
+*                            MSS_EDF_NO_DEADLINE
+*
+* @return     -
+*
+******************************************************************************/
+void mss_task_set_deadline(uint8_t task_id, mss_timer_tick_t rel_deadline)
+{
+  mss_int_flag_t int_flag;
+
+  // check task id
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  // takes effect with the next job of the task, the current one keeps its
+  // deadline and its place in the heap (see edf_job_start)
+  edf_rel_deadline[task_id] = rel_deadline;
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_task_get_deadline_misses
+*
+* @brief      get the number of jobs of a task which have finished after
+*             their absolute deadline
+*
+* @param[in]  task_id        task id number
+*
+* @return     number of deadline misses
+*
+******************************************************************************/
+uint16_t mss_task_get_deadline_misses(uint8_t task_id)
+{
+  uint16_t ret;
+  mss_int_flag_t int_flag;
+
+  // check task id
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  ret = edf_miss_cnt[task_id];
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+  return ret;
+}
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
 /**************************************************************************//**
 *
 * mss_get_running_task_id
@@ -336,3 +896,295 @@ uint8_t mss_get_running_task_id(void)
 //*****************************************************************************
 // Internal functions
 //*****************************************************************************
+
+#if (MSS_TASKS_PER_PRIO_LEVEL > 1)
+/**************************************************************************//**
+*
+* rr_get_next_task
+*
+* @brief      get the task to be executed next: the highest priority level
+*             with a ready task is taken, and within that level the next ready
+*             task after the one executed last (round-robin)
+*
+* @param[in]  ready_bits    the task ready bits
+*
+* @return     task id or MSS_INVALID_TASK_ID if no task is ready
+*
+******************************************************************************/
+static uint8_t rr_get_next_task(mss_task_bits_t ready_bits)
+{
+  uint8_t first;
+  mss_task_bits_t next_bits;
+
+  // the highest priority ready task gives the priority level
+  first = mss_get_highest_prio_task(ready_bits);
+
+  if(first != MSS_INVALID_TASK_ID)
+  {
+    // ready tasks of the level which have not had their turn yet
+    next_bits = ready_bits & MSS_PRIO_LEVEL_BITS(first) &
+                ~rr_done_bits[MSS_TASK_PRIO_LEVEL(first)];
+
+    if(next_bits)
+    {
+      first = mss_get_highest_prio_task(next_bits);
+    }
+  }
+
+  return first;
+}
+#endif /* (MSS_TASKS_PER_PRIO_LEVEL > 1) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* edf_before
+*
+* @brief      compare two tasks for EDF scheduling: the earlier absolute
+*             deadline wins, tasks without deadline come last, ties are
+*             resolved by task id
+*
+* @param[in]  a    first task id
+* @param[in]  b    second task id
+*
+* @return     true if task a shall be executed before task b
+*
+******************************************************************************/
+static bool edf_before(uint8_t a, uint8_t b)
+{
+  if(edf_job_deadline_bits & mss_bitpos_to_bit[a])
+  {
+    if(!(edf_job_deadline_bits & mss_bitpos_to_bit[b]))
+    {
+      return true;
+    }
+
+    if(edf_abs_deadline[a] != edf_abs_deadline[b])
+    {
+      return EDF_TICK_BEFORE(edf_abs_deadline[a], edf_abs_deadline[b]) ?
+             true : false;
+    }
+  }
+  else if(edf_job_deadline_bits & mss_bitpos_to_bit[b])
+  {
+    return false;
+  }
+
+  return (a < b);
+}
+
+/**************************************************************************//**
+*
+* edf_job_start
+*
+* @brief      start a new job of a task which is in the heap: set its
+*             absolute deadline and restore the heap order
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+******************************************************************************/
+static void edf_job_start(uint8_t task_id)
+{
+  if(edf_rel_deadline[task_id] != MSS_EDF_NO_DEADLINE)
+  {
+    edf_job_deadline_bits |= mss_bitpos_to_bit[task_id];
+  }
+  else
+  {
+    edf_job_deadline_bits &= ~mss_bitpos_to_bit[task_id];
+  }
+  edf_abs_deadline[task_id] = mss_timer_tick_cnt + edf_rel_deadline[task_id];
+
+  // the deadline can move in both directions
+  edf_heap_sift_up(edf_heap_pos[task_id]);
+  edf_heap_sift_down(edf_heap_pos[task_id]);
+}
+
+/**************************************************************************//**
+*
+* edf_job_finish
+*
+* @brief      a job of a task has finished, count a deadline miss if the
+*             absolute deadline has passed
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+******************************************************************************/
+static void edf_job_finish(uint8_t task_id)
+{
+  if((edf_job_deadline_bits & mss_bitpos_to_bit[task_id]) &&
+     EDF_TICK_BEFORE(edf_abs_deadline[task_id], mss_timer_tick_cnt))
+  {
+    edf_miss_cnt[task_id]++;
+  }
+}
+
+/**************************************************************************//**
+*
+* edf_heap_swap
+*
+* @brief      swap two entries of the deadline heap
+*
+* @param[in]  pos_a    heap position of first entry
+* @param[in]  pos_b    heap position of second entry
+*
+* @return     -
+*
+******************************************************************************/
+static void edf_heap_swap(uint8_t pos_a, uint8_t pos_b)
+{
+  uint8_t task_id;
+
+  task_id = edf_heap[pos_a];
+  edf_heap[pos_a] = edf_heap[pos_b];
+  edf_heap[pos_b] = task_id;
+
+  edf_heap_pos[edf_heap[pos_a]] = pos_a;
+  edf_heap_pos[edf_heap[pos_b]] = pos_b;
+}
+
+/**************************************************************************//**
+*
+* edf_heap_sift_up
+*
+* @brief      move a heap entry up until its parent is executed before it
+*
+* @param[in]  pos    heap position
+*
+* @return     -
+*
+******************************************************************************/
+static void edf_heap_sift_up(uint8_t pos)
+{
+  uint8_t parent;
+
+  while(pos > 0)
+  {
+    parent = (pos - 1) >> 1;
+
+    if(!edf_before(edf_heap[pos], edf_heap[parent]))
+    {
+      break;
+    }
+
+    edf_heap_swap(pos, parent);
+    pos = parent;
+  }
+}
+
+/**************************************************************************//**
+*
+* edf_heap_sift_down
+*
+* @brief      move a heap entry down until it is executed before its children
+*
+* @param[in]  pos    heap position
+*
+* @return     -
+*
+******************************************************************************/
+static void edf_heap_sift_down(uint8_t pos)
+{
+  uint8_t child;
+
+  while((child = (pos << 1) + 1) < edf_heap_size)
+  {
+    // take the earlier one of both children
+    if(((child + 1) < edf_heap_size) &&
+       edf_before(edf_heap[child + 1], edf_heap[child]))
+    {
+      child++;
+    }
+
+    if(!edf_before(edf_heap[child], edf_heap[pos]))
+    {
+      break;
+    }
+
+    edf_heap_swap(pos, child);
+    pos = child;
+  }
+}
+
+/**************************************************************************//**
+*
+* edf_heap_remove
+*
+* @brief      remove a task from the deadline heap
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+******************************************************************************/
+static void edf_heap_remove(uint8_t task_id)
+{
+  uint8_t pos;
+  uint8_t moved;
+
+  pos = edf_heap_pos[task_id];
+
+  if(pos != EDF_NOT_IN_HEAP)
+  {
+    // move the last entry into the gap
+    edf_heap_size--;
+    if(pos != edf_heap_size)
+    {
+      moved = edf_heap[edf_heap_size];
+      edf_heap_swap(pos, edf_heap_size);
+      edf_heap_sift_up(pos);
+      edf_heap_sift_down(edf_heap_pos[moved]);
+    }
+
+    edf_heap_pos[task_id] = EDF_NOT_IN_HEAP;
+  }
+}
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
+#if ((MSS_TASK_STATS == TRUE) || (MSS_TRACE == TRUE)) && \
+    (MSS_EDF_SCHEDULING == FALSE)
+/**************************************************************************//**
+*
+* record_activations
+*
+* @brief      count and trace the activations of several tasks at once
+*
+* @param[in]  activated      bits of the tasks which have been made ready
+* @param[in]  reactivated    bits of the running/preempted tasks which have
+*                            been activated again
+*
+* @return     -
+*
+******************************************************************************/
+static void record_activations(mss_task_bits_t activated,
+                               mss_task_bits_t reactivated)
+{
+  uint8_t task_id;
+
+  while(activated)
+  {
+    task_id = mss_get_highest_prio_task(activated);
+    activated &= ~mss_bitpos_to_bit[task_id];
+
+    MSS_TRACE_RECORD(MSS_TRACE_EV_ACTIVATE, task_id);
+  #if (MSS_TASK_STATS == TRUE)
+    task_stats[task_id].activations++;
+  #endif
+  }
+
+  while(reactivated)
+  {
+    task_id = mss_get_highest_prio_task(reactivated);
+    reactivated &= ~mss_bitpos_to_bit[task_id];
+
+    MSS_TRACE_RECORD(MSS_TRACE_EV_REACTIVATE, task_id);
+  #if (MSS_TASK_STATS == TRUE)
+    task_stats[task_id].reactivations++;
+  #endif
+  }
+}
+#endif
@@ -84,6 +84,14 @@
 #include "mss_sema.h"
 #endif
 
+#if (MSS_TASK_USE_RWLOCK == TRUE)
+#include "mss_rwlock.h"
+#endif
+
+#if (MSS_TASK_USE_BARRIER == TRUE)
+#include "mss_barrier.h"
+#endif
+
 #if (MSS_TASK_USE_MQUE == TRUE)
 #include "mss_mque.h"
 #endif
@@ -92,6 +100,18 @@
 #include "mss_mem.h"
 #endif
 
+#if (MSS_TRACE == TRUE)
+#include "mss_trace.h"
+#endif
+
+#if (MSS_LATENCY_STATS == TRUE)
+#include "mss_latency.h"
+#else
+#define MSS_LATENCY_ISR_ENTRY(src, task_id)
+#define MSS_LATENCY_ISR_STAMP(stamp)
+#define MSS_LATENCY_ISR_RECORD(src, task_id, stamp)
+#endif
+
 /**
  * @defgroup MSS_API  MSS API
  * @{
@@ -154,8 +174,73 @@ typedef uint16_t mss_task_ctx_t;
  */
 #define MSS_FINISH()      }
 
+/** MSS_TASK_CTX
+ *  context of the running task, stored in the task table - can be given to
+ *  the MSS_BEGIN and MSS_RETURN based macro functions
+ */
+#define MSS_TASK_CTX      (*mss_task_get_ctx())
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+/** MSS_TASK_TIMER
+ *  timer of the running task, stored in the task table
+ */
+#define MSS_TASK_TIMER    (mss_task_get_timer())
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+
 /** @} MSS Task Context */
 
+/**
+ * @name MSS Task Registration
+ * @{
+ */
+
+/** mss_task_t
+ *  mss task data type
+ */ 
+typedef void (*mss_task_t) (void*);
+
+/** MSS_INVALID_TASK_ID
+ *  invalid task id
+ */
+#define MSS_INVALID_TASK_ID            (0xFF)
+
+/** MSS_EDF_NO_DEADLINE
+ *  relative deadline value of a task without deadline (EDF scheduling)
+ */
+#define MSS_EDF_NO_DEADLINE            (0)
+
+/** MSS_TASK_PRIO_LOWEST_FREE
+ *  priority value for @ref mss_task_create to take the free task slot with
+ *  the lowest priority
+ */
+#define MSS_TASK_PRIO_LOWEST_FREE      (0xFF)
+
+/** @} MSS Task Registration */
+
+#if (MSS_TASK_STATS == TRUE)
+/**
+ * @name MSS Task Statistics
+ * @{
+ */
+
+/** mss_task_stats_t
+ *  run time and activation statistics of a task. Times are in timestamp
+ *  counts (see @ref MSS_TIMESTAMP_US) and do not include the time of
+ *  higher priority tasks preempting the task. A single run is measured
+ *  correctly up to the 16 bit range of the timestamp counter.
+ */
+typedef struct
+{
+  uint32_t run_time;        /**< accumulated run time of all invocations */
+  uint16_t max_run_time;    /**< longest single invocation */
+  uint16_t runs;            /**< number of invocations by the scheduler */
+  uint16_t activations;     /**< activations of the suspended/ready task */
+  uint16_t reactivations;   /**< activations while the task was running */
+} mss_task_stats_t;
+
+/** @} MSS Task Statistics */
+#endif /* (MSS_TASK_STATS == TRUE) */
+
 //*****************************************************************************
 // External function declarations
 //*****************************************************************************
@@ -205,6 +290,133 @@ void mss_run(void);
 ******************************************************************************/
 void mss_activate_task(uint8_t task_id);
 
+/**************************************************************************//**
+*
+* mss_task_create
+*
+* @brief      register a task in the task table. The task id is the priority
+*             slot (lower id means higher priority) and the task is
+*             activated right away to run its initialization part
+*
+* @param[in]  prio      priority slot (0 .. MSS_NUM_OF_TASKS-1), or
+*                       MSS_TASK_PRIO_LOWEST_FREE to take the lowest priority
+*                       free slot
+* @param[in]  task      task function
+* @param[in]  param     parameter given to the task function (can be NULL)
+*
+* @return     task id of the created task, MSS_INVALID_TASK_ID if the slot
+*             is already taken or no slot is free
+*
+* @remark     shall be called after @ref mss_init
+*
+******************************************************************************/
+uint8_t mss_task_create(uint8_t prio, mss_task_t task, void* param);
+
+/**************************************************************************//**
+*
+* mss_task_delete
+*
+* @brief      remove a task from the task table. A task can delete itself,
+*             it will not be executed again after it returns
+*
+* @param[in]  task_id    task id number
+*
+* @return     true if success, false if the slot is empty or the task is
+*             currently preempted
+*
+******************************************************************************/
+bool mss_task_delete(uint8_t task_id);
+
+/**************************************************************************//**
+*
+* mss_task_get_ctx
+*
+* @brief      get the context of the running task (see @ref MSS_TASK_CTX)
+*
+* @param      -
+*
+* @return     pointer to the context of the running task
+*
+******************************************************************************/
+mss_task_ctx_t* mss_task_get_ctx(void);
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+/**************************************************************************//**
+*
+* mss_task_get_timer
+*
+* @brief      get the timer of the running task (see @ref MSS_TASK_TIMER)
+*
+* @param      -
+*
+* @return     timer handle of the running task
+*
+******************************************************************************/
+mss_timer_t mss_task_get_timer(void);
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+
+#if (MSS_TASK_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_task_get_stats
+*
+* @brief      get a copy of the run time and activation statistics of a task
+*
+* @param[in]  task_id    task id number
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_task_get_stats(uint8_t task_id, mss_task_stats_t* stats);
+
+/**************************************************************************//**
+*
+* mss_task_reset_stats
+*
+* @brief      clear the statistics of a task
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+******************************************************************************/
+void mss_task_reset_stats(uint8_t task_id);
+#endif /* (MSS_TASK_STATS == TRUE) */
+
+#if (MSS_EDF_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* mss_task_set_deadline
+*
+* @brief      set the relative deadline of a task for EDF scheduling. Every
+*             activation of the task starts a job whose absolute deadline is
+*             the activation tick plus the relative deadline
+*
+* @param[in]  task_id        task id number
+* @param[in]  rel_deadline   relative deadline in timer ticks, or
+*                            MSS_EDF_NO_DEADLINE
+*
+* @return     -
+*
+******************************************************************************/
+void mss_task_set_deadline(uint8_t task_id, mss_timer_tick_t rel_deadline);
+
+/**************************************************************************//**
+*
+* mss_task_get_deadline_misses
+*
+* @brief      get the number of jobs of a task which have finished after
+*             their absolute deadline
+*
+* @param[in]  task_id        task id number
+*
+* @return     number of deadline misses
+*
+******************************************************************************/
+uint16_t mss_task_get_deadline_misses(uint8_t task_id);
+#endif /* (MSS_EDF_SCHEDULING == TRUE) */
+
 /**************************************************************************//**
 *
 * mss_get_running_task_id
@@ -222,9 +434,4 @@ uint8_t mss_get_running_task_id(void);
 
 /** @} MSS_General_API */
 
-struct TaskInstance {
-  mss_task_ctx_t State;
-  mss_timer_t Timer;
-};
-
 #endif /* _MSS_H_*/
@@ -0,0 +1,202 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_barrier.c
+* 
+* @brief    mcu simple scheduler task barrier module
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_TASK_USE_BARRIER
+*           defined as TRUE
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "mss.h"
+#include "mss_int.h"
+
+#if (MSS_TASK_USE_BARRIER == TRUE)
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+/** mss_barrier_tbl_t
+ *  mss task barrier table data type
+ */
+struct mss_barrier_tbl_t{
+  mss_task_bits_t participants;
+  mss_task_bits_t arrived;
+  mss_task_bits_t released;
+};
+
+// number of created barriers
+static uint8_t num_of_barrier = 0;
+
+// barrier table
+static struct mss_barrier_tbl_t barrier_tbl[MSS_MAX_NUM_OF_BARRIER];
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_barrier_create
+*
+* @brief      create a new task barrier without any participating task
+*
+* @param      -
+*
+* @return     handle to created barrier, MSS_BARRIER_INVALID_HDL if failure
+*
+******************************************************************************/
+mss_barrier_t mss_barrier_create(void)
+{
+  mss_barrier_t ret_hdl = MSS_BARRIER_INVALID_HDL;
+
+  // check if there is a free barrier block
+  if(num_of_barrier < MSS_MAX_NUM_OF_BARRIER)
+  {
+    // set initialization value of barrier block
+    barrier_tbl[num_of_barrier].participants = 0;
+    barrier_tbl[num_of_barrier].arrived = 0;
+    barrier_tbl[num_of_barrier].released = 0;
+
+    // return handle and increment number of barrier block
+    ret_hdl = &barrier_tbl[num_of_barrier++];
+  }
+
+  return ret_hdl;
+}
+
+/**************************************************************************//**
+*
+* mss_barrier_add_task
+*
+* @brief      add a task to the participants of a barrier. Shall be done
+*             before the participants start waiting at the barrier
+*
+* @param[in]  hdl        barrier handle
+* @param[in]  task_id    task id number of the participant
+*
+* @return     -
+*
+******************************************************************************/
+void mss_barrier_add_task(mss_barrier_t hdl, uint8_t task_id)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameters
+  MSS_DEBUG_CHECK(hdl != MSS_BARRIER_INVALID_HDL);
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  hdl->participants |= mss_bitpos_to_bit[task_id];
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_barrier_wait
+*
+* @brief      arrive at a barrier. The arrival of the running task is recorded
+*             in the arrival bits of the barrier. The final arrival releases
+*             the barrier and activates all other participants at once.
+*
+* @param[in]  hdl        barrier handle
+*
+* @return     if true the barrier has been released for the calling task,
+*             if false the task shall wait for the other participants
+*
+******************************************************************************/
+bool mss_barrier_wait(mss_barrier_t hdl)
+{
+  bool ret = false;
+  mss_task_bits_t task_bit;
+  mss_int_flag_t int_flag;
+
+  // check handle
+  MSS_DEBUG_CHECK(hdl != MSS_BARRIER_INVALID_HDL);
+
+  // turn running task id into bit position
+  task_bit = mss_bitpos_to_bit[mss_running_task_id];
+
+  // check that the running task participates
+  MSS_DEBUG_CHECK(hdl->participants & task_bit);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  if(hdl->released & task_bit)
+  {
+    // barrier was released by the final arrival of another task
+    hdl->released &= ~task_bit;
+    ret = true;
+  }
+  else
+  {
+    // record arrival of the running task
+    hdl->arrived |= task_bit;
+
+    if(hdl->arrived == hdl->participants)
+    {
+      // final arrival, release all other participants in one go
+      hdl->arrived = 0;
+      hdl->released = hdl->participants & ~task_bit;
+      mss_activate_tasks_int(hdl->released);
+      ret = true;
+    }
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+  return ret;
+}
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+#endif /* (MSS_TASK_USE_BARRIER == TRUE) */
@@ -0,0 +1,151 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_barrier.h
+* 
+* @brief    mcu simple scheduler task barrier module header file
+* 
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_TASK_USE_BARRIER
+*           defined as TRUE
+* 
+******************************************************************************/
+
+#ifndef _MSS_BARRIER_H_
+#define _MSS_BARRIER_H_
+
+/**
+ * @ingroup   MSS_API
+ * @defgroup  MSS_Barrier_API  MSS Task Barrier API
+ * @brief     MSS Task barrier (rendezvous) module API definitions, data
+ *            types, and functions (enabled only if
+ *            (MSS_TASK_USE_BARRIER == TRUE))
+ * @{
+ */
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Global variable declarations 
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+/**
+ * @name MSS Task Barrier handle
+ * @{
+ */
+
+/** mss_barrier_t
+ *  mss task barrier handle data type
+ */
+typedef struct mss_barrier_tbl_t*   mss_barrier_t;
+
+/** MSS_BARRIER_INVALID_HDL
+ *  invalid task barrier handle
+ */
+#define MSS_BARRIER_INVALID_HDL     ((mss_barrier_t)NULL)
+
+/** @} MSS Task Barrier handle */
+
+/**
+ * @name MSS Task Barrier API Functions
+ * @{
+ */
+
+/** MSS_BARRIER_WAIT
+ *  macro function to arrive at a barrier, and blocks until all participating
+ *  tasks have arrived
+ */
+#define MSS_BARRIER_WAIT(hdl, context)              \
+        do{while(mss_barrier_wait(hdl) == FALSE)    \
+           MSS_RETURN(context);}while(0)
+
+
+//*****************************************************************************
+// External function declarations
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_barrier_create
+*
+* @brief      create a new task barrier without any participating task
+*
+* @param      -
+*
+* @return     handle to created barrier, MSS_BARRIER_INVALID_HDL if failure
+*
+******************************************************************************/
+mss_barrier_t mss_barrier_create(void);
+
+/**************************************************************************//**
+*
+* mss_barrier_add_task
+*
+* @brief      add a task to the participants of a barrier. Shall be done
+*             before the participants start waiting at the barrier
+*
+* @param[in]  hdl        barrier handle
+* @param[in]  task_id    task id number of the participant
+*
+* @return     -
+*
+******************************************************************************/
+void mss_barrier_add_task(mss_barrier_t hdl, uint8_t task_id);
+
+/**************************************************************************//**
+*
+* mss_barrier_wait
+*
+* @brief      arrive at a barrier. The arrival of the running task is recorded
+*             in the arrival bits of the barrier. The final arrival releases
+*             the barrier and activates all other participants at once.
+*
+* @param[in]  hdl        barrier handle
+*
+* @return     if true the barrier has been released for the calling task,
+*             if false the task shall wait for the other participants
+*
+******************************************************************************/
+bool mss_barrier_wait(mss_barrier_t hdl);
+
+/** @} MSS Task Barrier API Functions */
+
+/** @} MSS_Barrier_API */
+
+#endif /* _MSS_BARRIER_H_*/
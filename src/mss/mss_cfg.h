@@ -45,7 +45,6 @@
 // Include section
 //*****************************************************************************
 
-// include header file containing declaration of task functions
 
 //*****************************************************************************
 // Global variable declarations 
@@ -57,33 +56,64 @@
 //*****************************************************************************
 
 /** MAX_NUM_OF_TASKS
- *  maximum number of MSS tasks. This shall not exceed the number of bits which
+ *  maximum number of MSS tasks (number of priority slots which can be taken
+ *  by @ref mss_task_create). This shall not exceed the number of bits which
  *  the @ref mss_task_bits_t has.
  */
 #define MSS_NUM_OF_TASKS                 (1)
 
-/** MSS_TASK_LIST
- *  list of task function and parameter pointers of each MSS task. The task 
- *  function pointer shall be a valid pointer to void (*) (void*) type function
- *  while the parameter pointers can take a NULL pointer. 
- */
-#define MSS_TASK_LIST                \
-        {                            \
-          {ControlTask, NULL},    \
-        }
-
-/** MSS_READY_TASK_BITS_INIT
- *  initialization value of MSS task ready bits. Each bit set represent the 
- *  task which is ready to be executed right at the beginning.
- */
-#define MSS_READY_TASK_BITS_INIT         (0x0001)
-
 /** MSS_PREEMPTIVE_SCHEDULING
  *  set to TRUE to activate preemptive scheduling, otherwise the scheduler
  *  will work cooperatively.
  */
 #define MSS_PREEMPTIVE_SCHEDULING        (FALSE)
 
+/** MSS_TASKS_PER_PRIO_LEVEL
+ *  number of tasks sharing one priority level (shall be a power of two).
+ *  Task ids 0 .. MSS_TASKS_PER_PRIO_LEVEL-1 form the highest priority level,
+ *  the next ids the following level, and so on. Ready tasks of the same level
+ *  are executed round-robin every time a task returns to the scheduler.
+ *  Set to 1 to have strict priority by task id.
+ */
+#define MSS_TASKS_PER_PRIO_LEVEL         (1)
+
+/** MSS_EDF_SCHEDULING
+ *  set to TRUE to schedule the ready tasks by earliest deadline first (EDF)
+ *  instead of by task id. Tasks get their relative deadline with
+ *  mss_task_set_deadline(), tasks without deadline run after all tasks with
+ *  deadline in task id order. Needs the MSS timer module and can not be
+ *  combined with MSS_TASKS_PER_PRIO_LEVEL > 1.
+ */
+#define MSS_EDF_SCHEDULING               (FALSE)
+
+/** MSS_TASK_STATS
+ *  set to TRUE to measure the run time of every task invocation with the
+ *  HAL timestamp counter and to count the activations of every task
+ *  (see @ref mss_task_get_stats). Costs some cycles around every task call.
+ */
+#define MSS_TASK_STATS                   (FALSE)
+
+/** MSS_TRACE
+ *  set to TRUE to record scheduler events (activation, start, yield,
+ *  preemption) with timestamp in a RAM ring buffer (see mss_trace.h)
+ */
+#define MSS_TRACE                        (FALSE)
+
+/** MSS_POWER_STATS
+ *  set to TRUE to let the HAL count active and sleep ticks per low power
+ *  mode, the wake-ups and their source (see mss_get_power_stats()). Needs
+ *  the MSS timer module.
+ */
+#define MSS_POWER_STATS                  (FALSE)
+
+/** MSS_LATENCY_STATS
+ *  set to TRUE to measure the latency from the entry of an interrupt
+ *  service routine (see MSS_LATENCY_ISR_ENTRY in mss_latency.h) to the
+ *  start of the task it activates, with min/avg/max and a histogram per
+ *  interrupt source
+ */
+#define MSS_LATENCY_STATS                (FALSE)
+
 /** MSS_TASK_USE_EVENT
  *  set to TRUE to activate the MSS event flag module. If it is not used,
  *  this option can be set as FALSE to save some memory space.
@@ -108,6 +138,18 @@
  */
 #define MSS_TASK_USE_SEMA                (FALSE)
 
+/** MSS_TASK_USE_RWLOCK
+ *  set to TRUE to activate the MSS reader-writer lock module. If it is not
+ *  used, this option can be set as FALSE to save some memory space.
+ */
+#define MSS_TASK_USE_RWLOCK              (FALSE)
+
+/** MSS_TASK_USE_BARRIER
+ *  set to TRUE to activate the MSS task barrier module. If it is not used,
+ *  this option can be set as FALSE to save some memory space.
+ */
+#define MSS_TASK_USE_BARRIER             (FALSE)
+
 /** MSS_TASK_USE_MEM
  *  set to TRUE to activate the MSS memory block. If it is not used,
  *  this option can be set as FALSE to save some memory space.
@@ -115,7 +157,9 @@
 #define MSS_TASK_USE_MEM                 (FALSE)
 
 /** MSS_MAX_NUM_OF_TIMER
- *  maximum number of timer used in the MSS application. 
+ *  maximum number of timer used in the MSS application. Every task slot
+ *  gets its own timer on its first @ref mss_task_create, which shall be
+ *  counted here as well.
  *  If @ref MSS_TASK_USE_TIMER is set as FALSE, this value will be 
  *  automativally set to zero
  */
@@ -142,6 +186,17 @@ typedef uint16_t mss_timer_tick_t;
 typedef uint8_t  mss_event_t;
 #endif
 
+/** MSS_LATENCY_NUM_OF_BUCKETS
+ *  number of latency histogram buckets
+ */
+#define MSS_LATENCY_NUM_OF_BUCKETS       (8)
+
+/** MSS_LATENCY_BUCKET_BASE
+ *  upper bound of the first latency histogram bucket in timestamp counts,
+ *  every following bucket doubles the bound
+ */
+#define MSS_LATENCY_BUCKET_BASE          (16)
+
 /** MSS_MAX_NUM_OF_MQUE
  *  maximum number of message queues used in the MSS application. 
  *  If @ref MSS_TASK_USE_MQUE is set as FALSE, this value will be 
@@ -154,7 +209,9 @@ typedef uint8_t  mss_event_t;
 #endif
 
 /** MSS_MAX_NUM_OF_SEMA
- *  maximum number of semaphores used in the MSS application. 
+ *  maximum number of semaphores used in the MSS application. Every
+ *  semaphore takes 2 * MSS_NUM_OF_TASKS bytes of RAM for the units held
+ *  per task (see mss_sema_wait_n) on top of its value and task bits.
  *  If @ref MSS_TASK_USE_SEMA is set as FALSE, this value will be 
  *  automativally set to zero
  */
@@ -164,6 +221,28 @@ typedef uint8_t  mss_event_t;
   #define MSS_MAX_NUM_OF_SEMA            (0)
 #endif
 
+/** MSS_MAX_NUM_OF_RWLOCK
+ *  maximum number of reader-writer locks used in the MSS application. 
+ *  If @ref MSS_TASK_USE_RWLOCK is set as FALSE, this value will be 
+ *  automativally set to zero
+ */
+#if (MSS_TASK_USE_RWLOCK == TRUE)
+  #define MSS_MAX_NUM_OF_RWLOCK          (1)
+#else
+  #define MSS_MAX_NUM_OF_RWLOCK          (0)
+#endif
+
+/** MSS_MAX_NUM_OF_BARRIER
+ *  maximum number of task barriers used in the MSS application. 
+ *  If @ref MSS_TASK_USE_BARRIER is set as FALSE, this value will be 
+ *  automativally set to zero
+ */
+#if (MSS_TASK_USE_BARRIER == TRUE)
+  #define MSS_MAX_NUM_OF_BARRIER         (1)
+#else
+  #define MSS_MAX_NUM_OF_BARRIER         (0)
+#endif
+
 /** MSS_MAX_NUM_OF_MEM
  *  maximum number of memory blocks used in the MSS application. 
  *  If @ref MSS_TASK_USE_MEM is set as FALSE, this value will be 
@@ -185,4 +264,38 @@ typedef uint8_t  mss_event_t;
 // External function declarations
 //*****************************************************************************
 
+#if defined(MSS_CFG_FILE)
+// overrides of another build, e.g. the host port (host/mss_cfg_host.h)
+#include MSS_CFG_FILE
+#endif
+
+// sizes derived from the options above, after the overrides so that they
+// follow an override of the option (an override may also set the size)
+
+/** MSS_TRACE_BUF_SIZE
+ *  number of 4 byte records in the trace ring buffer (shall be a power of
+ *  two). If @ref MSS_TRACE is set as FALSE, this value will be
+ *  automatically set to zero
+ */
+#if !defined(MSS_TRACE_BUF_SIZE)
+#if (MSS_TRACE == TRUE)
+  #define MSS_TRACE_BUF_SIZE             (32)
+#else
+  #define MSS_TRACE_BUF_SIZE             (0)
+#endif
+#endif
+
+/** MSS_LATENCY_NUM_OF_SRC
+ *  number of interrupt sources with latency measurement. If
+ *  @ref MSS_LATENCY_STATS is set as FALSE, this value will be
+ *  automatically set to zero
+ */
+#if !defined(MSS_LATENCY_NUM_OF_SRC)
+#if (MSS_LATENCY_STATS == TRUE)
+  #define MSS_LATENCY_NUM_OF_SRC         (3)
+#else
+  #define MSS_LATENCY_NUM_OF_SRC         (0)
+#endif
+#endif
+
 #endif /* _MSS_CFG_H_*/
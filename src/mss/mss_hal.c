@@ -60,10 +60,33 @@
 static mss_timer_tick_t delay_timer_cnt = 0;
 #endif /* (MSS_TASK_USE_TIMER == TRUE) */
 
+// Timer0_A counts of one mss timer tick
+#define TICK_COUNTS              (MSS_HAL_TIMER_US(MSS_TIMER_TICK_MS * 1000UL))
+
+// compare channels of Timer0_A: expiry handler (NULL: free) and the counter
+// periods left before the compare match that expires a channel
+static mss_hal_timer_handler_t timer_handler[MSS_HAL_TIMER_NUM];
+static uint16_t timer_laps[MSS_HAL_TIMER_NUM];
+
+// compare registers of a channel, TACCTLx and TACCRx are consecutive words
+#define TIMER_CCTL(ch)           ((&TACCTL0)[ch])
+#define TIMER_CCR(ch)            ((&TACCR0)[ch])
+
+#if (MSS_POWER_STATS == TRUE)
+// idle/sleep statistics
+static mss_power_stats_t power_stats;
+
+// set while the CPU sleeps in mss_hal_sleep until the first wake-up source
+// has been recorded
+static volatile bool power_sleeping = false;
+#endif /* (MSS_POWER_STATS == TRUE) */
+
 //*****************************************************************************
 // Internal function declarations
 //*****************************************************************************
 
+static bool timer_expired(uint8_t ch);
+
 
 //*****************************************************************************
 // External functions
@@ -79,6 +102,8 @@ static mss_timer_tick_t delay_timer_cnt = 0;
 *               setup timer interrupt which shall increment the timer counter
 *               mss_timer_tick_cnt and call @ref mss_timer_tick() function 
 *               periodically
+*             - start the Timer0_A counter shared by the mss timer tick, the
+*               timestamps and the drivers (@ref mss_hal_timer_alloc)
 *             - if @ref MSS_PREEMPTIVE_SCHEDULING is set to TRUE, setup the
 *               software interrupt or hardware interrupt which is used to call
 *               mss_scheduler during preemption
@@ -100,7 +125,7 @@ void mss_hal_init(void)
   BCSCTL1 = XT2OFF | CALBC1_8MHZ;
   DCOCTL = CALDCO_8MHZ;
   BCSCTL2 |= DIVS_3;  // 1 MHz SMCLK
-  BCSCTL3 = LFXT1S_2; // source VLOCLK as ACLK
+  BCSCTL3 = LFXT1S_2; // source VLOCLK as ACLK, for all modules
 
   // wait until clock stabilizes
   do
@@ -110,15 +135,20 @@ void mss_hal_init(void)
   } while(IFG1 & OFIFG);
 
 #if (MSS_TASK_USE_TIMER == TRUE)
-  // use watchdog timer to generate mss timer interrupt tick
-  WDTCTL = WDT_MDLY_0_5; 
-  IE1 |= WDTIE;
+  // compare channel 1 generates the mss timer tick
+  timer_handler[MSS_HAL_TIMER_TICK] = NULL;
+  TACCR1 = TICK_COUNTS;
+  TACCTL1 = CCIE;
 #endif
+
+  // Timer0_A free-running on SMCLK, never stopped or cleared again
+  TACTL = TASSEL_2 | MC_2 | TACLR;
   
 #if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
   // enable interrupt
   CACTL1 = CAIE;
 #endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+
 }
 
 /**************************************************************************//**
@@ -154,11 +184,24 @@ void mss_hal_sleep(mss_timer_tick_t sleep_timeout)
   sleep_timeout = sleep_timeout;
 #endif /* (MSS_TASK_USE_TIMER == TRUE) */
 
-  // go to LPM0 to keep SMCLK generating WDT interrupt
+#if (MSS_POWER_STATS == TRUE)
+  power_sleeping = true;
+#endif
+
+  // go to LPM0 to keep SMCLK clocking Timer0_A
   __bis_SR_register(LPM0_bits + GIE);
 
   // disable interrupt
   __disable_interrupt();
+
+#if (MSS_POWER_STATS == TRUE)
+  if(power_sleeping)
+  {
+    // the waking ISR did not tell its source
+    mss_hal_note_wakeup(MSS_WAKE_SRC_OTHER);
+  }
+  power_stats.wake_cnt++;
+#endif /* (MSS_POWER_STATS == TRUE) */
 }
 
 #if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
@@ -181,6 +224,238 @@ void mss_hal_trigger_sw_int(void)
 }
 #endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
 
+#if defined(MSS_TIMESTAMP_US)
+/**************************************************************************//**
+*
+* mss_hal_get_timestamp
+*
+* @brief      read the free-running timestamp counter (one count is
+*             @ref MSS_TIMESTAMP_US microseconds)
+*
+* @param      -
+*
+* @return     current timestamp counter value
+*
+******************************************************************************/
+uint16_t mss_hal_get_timestamp(void)
+{
+  // Timer0_A runs synchronous to MCLK, so it can be read directly
+  return TAR;
+}
+#endif /* defined(MSS_TIMESTAMP_US) */
+
+/**************************************************************************//**
+*
+* mss_hal_timer_alloc
+*
+* @brief      allocate a free compare channel of Timer0_A to a driver, the
+*             channel stays allocated
+*
+* @param[in]  handler    called from the ISR when the channel expires
+*
+* @return     channel number or MSS_HAL_TIMER_NONE if all are in use
+*
+******************************************************************************/
+uint8_t mss_hal_timer_alloc(mss_hal_timer_handler_t handler)
+{
+  uint8_t ch;
+
+  // check parameter
+  MSS_DEBUG_CHECK(handler != NULL);
+
+  for(ch=0 ; ch<MSS_HAL_TIMER_NUM ; ch++)
+  {
+    if((ch != MSS_HAL_TIMER_TICK) && (timer_handler[ch] == NULL))
+    {
+      timer_handler[ch] = handler;
+      return ch;
+    }
+  }
+
+  return MSS_HAL_TIMER_NONE;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_timer_start
+*
+* @brief      (re)start a one-shot time on an allocated channel, longer times
+*             than one counter period take more compare matches
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc
+* @param[in]  counts     time in counts, see @ref MSS_HAL_TIMER_US (at least
+*                        @ref MSS_HAL_TIMER_MIN)
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_timer_start(uint8_t ch, uint32_t counts)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameters
+  MSS_DEBUG_CHECK((ch < MSS_HAL_TIMER_NUM) && (timer_handler[ch] != NULL));
+  MSS_DEBUG_CHECK(counts >= MSS_HAL_TIMER_MIN);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  // the first match is (counts mod 65536) ahead, or a whole period if 0
+  timer_laps[ch] = (uint16_t)((counts - 1) >> 16);
+  TIMER_CCR(ch) = TAR + (uint16_t)counts;
+  TIMER_CCTL(ch) = CCIE;
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_timer_stop
+*
+* @brief      stop the time of an allocated channel, its handler is not
+*             called
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_timer_stop(uint8_t ch)
+{
+  // check parameter
+  MSS_DEBUG_CHECK(ch < MSS_HAL_TIMER_NUM);
+
+  TIMER_CCTL(ch) = 0;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_timer_free
+*
+* @brief      stop an allocated channel and give it back, so that a driver
+*             can borrow a channel during initialization
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_timer_free(uint8_t ch)
+{
+  // check parameter
+  MSS_DEBUG_CHECK((ch < MSS_HAL_TIMER_NUM) && (ch != MSS_HAL_TIMER_TICK));
+
+  TIMER_CCTL(ch) = 0;
+  timer_handler[ch] = NULL;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_timer_capture
+*
+* @brief      wait for the next rising edge of ACLK and capture the counter
+*             on an allocated channel (CCIxB is ACLK on the channels 0 and 2
+*             of the MSP430G2553), the channel stays in capture mode until
+*             it is stopped or started
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc, no time running
+*
+* @return     Timer0_A counter at the edge
+*
+******************************************************************************/
+uint16_t mss_hal_timer_capture(uint8_t ch)
+{
+  // check parameter
+  MSS_DEBUG_CHECK((ch < MSS_HAL_TIMER_NUM) && (timer_handler[ch] != NULL));
+
+  // capture without interrupt, the handler of the channel is not called
+  if((TIMER_CCTL(ch) & CAP) == 0)
+  {
+    TIMER_CCTL(ch) = CM_1 | CCIS_1 | CAP;
+  }
+
+  TIMER_CCTL(ch) &= ~CCIFG;
+  while((TIMER_CCTL(ch) & CCIFG) == 0);
+
+  return TIMER_CCR(ch);
+}
+
+#if (MSS_POWER_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_get_power_stats
+*
+* @brief      get a copy of the idle/sleep statistics
+*
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_get_power_stats(mss_power_stats_t* stats)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameter
+  MSS_DEBUG_CHECK(stats != NULL);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  *stats = power_stats;
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_reset_power_stats
+*
+* @brief      clear the idle/sleep statistics
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_reset_power_stats(void)
+{
+  mss_int_flag_t int_flag;
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  memset(&power_stats, 0, sizeof(power_stats));
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_note_wakeup
+*
+* @brief      record the source of a wake-up if the MSS is sleeping - used by
+*             @ref MSS_HAL_WAKEUP_FROM_ISR
+*
+* @param[in]  src        one of the MSS_WAKE_SRC_xxx values
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_note_wakeup(uint8_t src)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameter
+  MSS_DEBUG_CHECK(src < MSS_NUM_OF_WAKE_SRC);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  // only the first source ending the sleep counts
+  if(power_sleeping)
+  {
+    power_sleeping = false;
+    power_stats.last_wake_src = src;
+    power_stats.wake_src_cnt[src]++;
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+#endif /* (MSS_POWER_STATS == TRUE) */
+
 /**************************************************************************//**
 *
 * mss_get_highest_prio_task
@@ -218,33 +493,116 @@ uint8_t mss_get_highest_prio_task(mss_task_bits_t ready_bits)
 // Internal functions
 //*****************************************************************************
 
-#if (MSS_TASK_USE_TIMER == TRUE)
+/**************************************************************************//**
+*
+* timer_expired
+*
+* @brief      compare match of an allocated channel, calls its handler once
+*             the last counter period of its time has passed
+*
+* @param[in]  ch         channel
+*
+* @return     true if the handler asks to wake up the CPU
+*
+******************************************************************************/
+static bool timer_expired(uint8_t ch)
+{
+  if(timer_laps[ch] > 0)
+  {
+    // same compare value, matches again one counter period later
+    timer_laps[ch]--;
+    return false;
+  }
+
+  TIMER_CCTL(ch) = 0;
+  return timer_handler[ch]();
+}
+
 /**************************************************************************//**
 * 
-* WDT_ISR
+* TimerA0_ISR
 * 
-* @brief      Watchdog Timer interrupt service routine
+* @brief      Timer0_A compare channel 0 interrupt service routine
 *
 * @param      -
 * 
 * @return     -
 * 
 ******************************************************************************/
-#pragma vector=WDT_VECTOR
-__interrupt void WDT_ISR(void)
+#pragma vector=TIMER0_A0_VECTOR
+__interrupt void TimerA0_ISR(void)
 {
-  static uint8_t internal_tick = 0;
-  
-  // call mss timer tick function every four ticks to produce ~1ms timer tick
-  if(internal_tick++ & 0x01)
+  if(timer_expired(0))
   {
+    MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_TIMER);
+  }
+}
+
+/**************************************************************************//**
+* 
+* TimerA1_ISR
+* 
+* @brief      Timer0_A compare channels 1 and 2 interrupt service routine,
+*             channel 1 is the mss timer tick
+*
+* @param      -
+* 
+* @return     -
+* 
+******************************************************************************/
+#pragma vector=TIMER0_A1_VECTOR
+__interrupt void TimerA1_ISR(void)
+{
+#if (MSS_TASK_USE_TIMER == TRUE)
+  mss_timer_tick_t ticks = 0;
+#if (MSS_POWER_STATS == TRUE)
+  uint16_t sr;
+#endif
+#endif
+
+  // reading TAIV clears the flag of the highest pending channel
+  switch(TAIV)
+  {
+  case TA0IV_TACCR1:
+#if (MSS_TASK_USE_TIMER == TRUE)
+#if (MSS_POWER_STATS == TRUE)
+    // sample the CPU state of the interrupted code
+    sr = __get_SR_register_on_exit();
+    if(!(sr & CPUOFF))
+    {
+      power_stats.active_ticks++;
+    }
+    else if(sr & OSCOFF)
+    {
+      power_stats.sleep_ticks[4]++;
+    }
+    else
+    {
+      // SCG1:SCG0 gives LPM0 .. LPM3
+      power_stats.sleep_ticks[(sr & (SCG1 | SCG0)) >> 6]++;
+    }
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+    // next tick, without drift. The ticks the counter has passed while
+    // the interrupts were off (a flash erase holds the CPU for about
+    // 20 ms) are caught up, else the next compare match would only come
+    // after a wrap of the counter. A compare value written equal to the
+    // counter gives no match either, so equal counts as passed.
+    do
+    {
+      TACCR1 += TICK_COUNTS;
+      TACCTL1 &= ~CCIFG;
+      ticks++;
+    } while((int16_t)(TAR - TACCR1) >= 0);
+
     // increment mss timer tick
-	mss_timer_tick_cnt++;
+    mss_timer_tick_cnt += ticks;
 
     if(delay_timer_cnt)
     {
       // decrement counter
-      delay_timer_cnt--;
+      delay_timer_cnt = (delay_timer_cnt > ticks) ?
+                        (delay_timer_cnt - ticks) : 0;
     }
 
     if(delay_timer_cnt == 0)
@@ -255,12 +613,23 @@ __interrupt void WDT_ISR(void)
       // wake up CPU if MSS is in sleep mode
       if(mss_timer_tick())
       {
-        __bic_SR_register_on_exit(LPM0_bits);
+        MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_TIMER);
       }
     }
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+    break;
+
+  case TA0IV_TACCR2:
+    if(timer_expired(2))
+    {
+      MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_TIMER);
+    }
+    break;
+
+  default:
+    break;
   }
 }
-#endif
 
 #if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
 /**************************************************************************//**
@@ -280,11 +649,19 @@ __interrupt void SwInt_ISR(void)
   // clear flag
   CACTL1 &= ~CAIFG;
 
+  MSS_TRACE_RECORD(MSS_TRACE_EV_PREEMPT, mss_running_task_id);
+
   // enable interrupt
   __enable_interrupt();
 
   // call the scheduler
   mss_scheduler();
+
+#if (MSS_TRACE == TRUE)
+  // the preempted task continues after the return from interrupt
+  __disable_interrupt();
+  MSS_TRACE_RECORD(MSS_TRACE_EV_RESUME, mss_running_task_id);
+#endif
 }
 #endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
 
@@ -43,6 +43,14 @@
 #ifndef _MSS_HAL_H_
 #define _MSS_HAL_H_
 
+#if defined(MSS_HAL_POSIX)
+// host port (see mss_hal_posix.c)
+#include "mss_hal_posix.h"
+#elif defined(MSS_HAL_SIM)
+// virtual-time simulation port (see mss_hal_sim.c)
+#include "mss_hal_sim.h"
+#else
+
 //*****************************************************************************
 // Include section
 //*****************************************************************************
@@ -100,8 +108,212 @@ typedef uint16_t mss_int_flag_t;
 #define MSS_TIMER_TICK_MS              (1)
 #endif
 
+/** MSS_HAL_TIMER_xxx
+ *  compare channels of Timer0_A, which counts SMCLK (1 MHz) in continuous
+ *  mode and is never reconfigured: CCR1 generates the mss timer tick, CCR0
+ *  and CCR2 are handed out to drivers by @ref mss_hal_timer_alloc
+ */
+#define MSS_HAL_TIMER_NUM              (3)
+#define MSS_HAL_TIMER_TICK             (1)
+#define MSS_HAL_TIMER_NONE             (0xFF)
+
+/** MSS_HAL_TIMER_US
+ *  Timer0_A counts of a time in microseconds
+ */
+#define MSS_HAL_TIMER_US(us)           ((uint32_t)(us))
+
+/** MSS_HAL_TIMER_MIN
+ *  shortest time of @ref mss_hal_timer_start in counts, a compare value
+ *  closer to the counter could be passed before it is written
+ */
+#define MSS_HAL_TIMER_MIN              (10)
+
+/** mss_hal_timer_handler_t
+ *  expiry handler of a compare channel, called from the Timer0_A ISR -
+ *  returns true to wake up the CPU (e.g. after it activated a task)
+ */
+typedef bool (*mss_hal_timer_handler_t)(void);
+
+#if (MSS_TASK_STATS == TRUE) || (MSS_TRACE == TRUE) || \
+    (MSS_LATENCY_STATS == TRUE)
+/** MSS_TIMESTAMP_US
+ *  time for one timestamp count of @ref mss_hal_get_timestamp in
+ *  microseconds - the Timer0_A counter (SMCLK, 1 MHz)
+ */
+#define MSS_TIMESTAMP_US               (1)
+#endif
+
+#if (MSS_POWER_STATS == TRUE)
+/** MSS_POWER_TICK_US
+ *  time of one active/sleep tick of @ref mss_power_stats_t in microseconds
+ *  (the mss timer tick, which samples the CPU state)
+ */
+#define MSS_POWER_TICK_US              (1000)
+
+/** MSS_NUM_OF_LPM
+ *  number of low power modes of the device (LPM0 .. LPM4)
+ */
+#define MSS_NUM_OF_LPM                 (5)
+
+/** MSS_WAKE_SRC_xxx
+ *  wake-up sources given to @ref MSS_HAL_WAKEUP_FROM_ISR
+ */
+#define MSS_WAKE_SRC_TIMER             (0)
+#define MSS_WAKE_SRC_UART              (1)
+#define MSS_WAKE_SRC_PORT              (2)
+#define MSS_WAKE_SRC_OTHER             (3)
+#define MSS_NUM_OF_WAKE_SRC            (4)
+
+/** mss_power_stats_t
+ *  idle/sleep statistics of the device
+ */
+typedef struct
+{
+  uint32_t active_ticks;                      /**< ticks with running CPU */
+  uint32_t sleep_ticks[MSS_NUM_OF_LPM];       /**< ticks in each LPM */
+  uint16_t wake_cnt;                          /**< number of wake-ups */
+  uint16_t wake_src_cnt[MSS_NUM_OF_WAKE_SRC]; /**< wake-ups per source */
+  uint8_t last_wake_src;                      /**< source of last wake-up */
+} mss_power_stats_t;
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+/** MSS_HAL_WAKEUP_FROM_ISR
+ *  wake up the MSS from sleep mode at the end of an interrupt service
+ *  routine, shall be called directly in the ISR function. The source is
+ *  one of the MSS_WAKE_SRC_xxx values and only used if MSS_POWER_STATS
+ *  is TRUE.
+ */
+#if (MSS_POWER_STATS == TRUE)
+#define MSS_HAL_WAKEUP_FROM_ISR(src)   do {                   \
+                               mss_hal_note_wakeup(src);      \
+                               __bic_SR_register_on_exit(LPM4_bits); \
+                               } while(0)
+#else
+#define MSS_HAL_WAKEUP_FROM_ISR(src)   do {                   \
+                               __bic_SR_register_on_exit(LPM4_bits); \
+                               } while(0)
+#endif /* (MSS_POWER_STATS == TRUE) */
+
 //*****************************************************************************
 // External function declarations
 //*****************************************************************************
 
+/**************************************************************************//**
+*
+* mss_hal_timer_alloc
+*
+* @brief      allocate a free compare channel of Timer0_A to a driver, the
+*             channel stays allocated
+*
+* @param[in]  handler    called from the ISR when the channel expires
+*
+* @return     channel number or MSS_HAL_TIMER_NONE if all are in use
+*
+******************************************************************************/
+uint8_t mss_hal_timer_alloc(mss_hal_timer_handler_t handler);
+
+/**************************************************************************//**
+*
+* mss_hal_timer_start
+*
+* @brief      (re)start a one-shot time on an allocated channel, longer times
+*             than one counter period take more compare matches
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc
+* @param[in]  counts     time in counts, see @ref MSS_HAL_TIMER_US (at least
+*                        @ref MSS_HAL_TIMER_MIN)
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_timer_start(uint8_t ch, uint32_t counts);
+
+/**************************************************************************//**
+*
+* mss_hal_timer_stop
+*
+* @brief      stop the time of an allocated channel, its handler is not
+*             called
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_timer_stop(uint8_t ch);
+
+/**************************************************************************//**
+*
+* mss_hal_timer_free
+*
+* @brief      stop an allocated channel and give it back, so that a driver
+*             can borrow a channel during initialization
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_timer_free(uint8_t ch);
+
+/**************************************************************************//**
+*
+* mss_hal_timer_capture
+*
+* @brief      wait for the next rising edge of ACLK and capture the counter
+*             on an allocated channel (CCIxB is ACLK on the channels 0 and 2
+*             of the MSP430G2553), the channel stays in capture mode until
+*             it is stopped or started
+*
+* @param[in]  ch         channel from @ref mss_hal_timer_alloc, no time running
+*
+* @return     Timer0_A counter at the edge
+*
+******************************************************************************/
+uint16_t mss_hal_timer_capture(uint8_t ch);
+
+#if (MSS_POWER_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_get_power_stats
+*
+* @brief      get a copy of the idle/sleep statistics
+*
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_get_power_stats(mss_power_stats_t* stats);
+
+/**************************************************************************//**
+*
+* mss_reset_power_stats
+*
+* @brief      clear the idle/sleep statistics
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_reset_power_stats(void);
+
+/**************************************************************************//**
+*
+* mss_hal_note_wakeup
+*
+* @brief      record the source of a wake-up if the MSS is sleeping - used by
+*             @ref MSS_HAL_WAKEUP_FROM_ISR
+*
+* @param[in]  src        one of the MSS_WAKE_SRC_xxx values
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_note_wakeup(uint8_t src);
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+#endif /* defined(MSS_HAL_POSIX) / defined(MSS_HAL_SIM) */
+
 #endif /* _MSS_HAL_H_*/
@@ -60,7 +60,13 @@
  *  enable global interrupt of the target device. This function is only called
  *  once in @ref mss_run() function.
  */
+#if defined(MSS_HAL_POSIX)
+#define MSS_ENABLE_GLOBAL_INTERRUPT()       mss_hal_posix_enable_int()
+#elif defined(MSS_HAL_SIM)
+#define MSS_ENABLE_GLOBAL_INTERRUPT()       mss_hal_sim_restore_int(1)
+#else
 #define MSS_ENABLE_GLOBAL_INTERRUPT()       __enable_interrupt()
+#endif
 
 
 //*****************************************************************************
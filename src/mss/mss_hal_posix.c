@@ -0,0 +1,392 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_hal_posix.c
+* 
+* @brief    mcu simple scheduler HAL (hardware abstraction layer) module for
+*           POSIX hosts
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_HAL_POSIX is
+*           defined. The maskable interrupts are mapped to signals:
+*           - SIGALRM from a POSIX timer generates the MSS timer tick
+*           - SIGUSR1 is the software interrupt for the preemption
+*           Critical sections block both signals, sleeping is sigsuspend.
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "mss.h"
+#include "mss_int.h"
+
+#if defined(MSS_HAL_POSIX)
+
+#include <pthread.h>
+#include <time.h>
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+/** SIG_TICK
+ *  signal of the MSS timer tick
+ */
+#define SIG_TICK                 (SIGALRM)
+
+/** SIG_SW_INT
+ *  signal of the software interrupt
+ */
+#define SIG_SW_INT               (SIGUSR1)
+
+// the signals which play the role of the maskable interrupts
+static sigset_t int_sigs;
+
+// set by a signal handler to let mss_hal_sleep return
+static volatile sig_atomic_t wakeup = 0;
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+static mss_timer_tick_t delay_timer_cnt = 0;
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+static void tick_handler(int sig);
+#endif
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+static void sw_int_handler(int sig);
+#endif
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_hal_init
+*
+* @brief      initialize mss HAL unit: install the signal handlers and start
+*             the POSIX timer for the MSS timer tick
+*
+* @param      -
+*
+* @return     -
+*
+* @remark     the interrupt signals stay blocked until mss_run
+*
+******************************************************************************/
+void mss_hal_init(void)
+{
+  struct sigaction sa;
+#if (MSS_TASK_USE_TIMER == TRUE)
+  timer_t timer;
+  struct sigevent sev;
+  struct itimerspec its;
+#endif
+
+  sigemptyset(&int_sigs);
+  sigaddset(&int_sigs, SIG_TICK);
+  sigaddset(&int_sigs, SIG_SW_INT);
+
+  // "global interrupt disabled" after reset
+  pthread_sigmask(SIG_BLOCK, &int_sigs, NULL);
+
+  memset(&sa, 0, sizeof(sa));
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+  sa.sa_handler = sw_int_handler;
+  sigaction(SIG_SW_INT, &sa, NULL);
+#endif
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+  // a tick shall not interrupt the software interrupt entry
+  sigaddset(&sa.sa_mask, SIG_SW_INT);
+  sa.sa_handler = tick_handler;
+  sigaction(SIG_TICK, &sa, NULL);
+
+  memset(&sev, 0, sizeof(sev));
+  sev.sigev_notify = SIGEV_SIGNAL;
+  sev.sigev_signo = SIG_TICK;
+  timer_create(CLOCK_MONOTONIC, &sev, &timer);
+
+  its.it_value.tv_sec = 0;
+  its.it_value.tv_nsec = MSS_TIMER_TICK_MS * 1000000L;
+  its.it_interval = its.it_value;
+  timer_settime(timer, 0, &its, NULL);
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sleep
+*
+* @brief      wait for signals until a signal handler wakes up the MSS
+*
+* @param[in]  sleep_timeout   sleep timeout in ticks (if MSS_SLEEP_NO_TIMEOUT,
+*                             no sleep timeout)
+*
+* @return     -
+*
+* @remark     called with blocked interrupt signals, sigsuspend unblocks
+*             them atomically while waiting
+*
+******************************************************************************/
+void mss_hal_sleep(mss_timer_tick_t sleep_timeout)
+{
+  sigset_t wait_mask;
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+  if(sleep_timeout != MSS_SLEEP_NO_TIMEOUT)
+  {
+    // save delay timer ticks
+    delay_timer_cnt = sleep_timeout;
+  }
+#else
+  // make compiler quiet
+  sleep_timeout = sleep_timeout;
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+
+  pthread_sigmask(SIG_BLOCK, NULL, &wait_mask);
+  sigdelset(&wait_mask, SIG_TICK);
+  sigdelset(&wait_mask, SIG_SW_INT);
+
+  wakeup = 0;
+  while(!wakeup)
+  {
+    sigsuspend(&wait_mask);
+  }
+}
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* mss_hal_trigger_sw_int
+*
+* @brief      trigger software interrupt - the signal stays pending until the
+*             critical section of the caller is left
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_trigger_sw_int(void)
+{
+  pthread_kill(pthread_self(), SIG_SW_INT);
+}
+#endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+
+#if defined(MSS_TIMESTAMP_US)
+/**************************************************************************//**
+*
+* mss_hal_get_timestamp
+*
+* @brief      read the free-running timestamp counter (one count is
+*             @ref MSS_TIMESTAMP_US microseconds)
+*
+* @param      -
+*
+* @return     current timestamp counter value
+*
+******************************************************************************/
+uint16_t mss_hal_get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint16_t)((ts.tv_sec * 1000000L) + (ts.tv_nsec / 1000));
+}
+#endif /* defined(MSS_TIMESTAMP_US) */
+
+/**************************************************************************//**
+*
+* mss_get_highest_prio_task
+*
+* @brief      get the highest priority task (LSB bit position of the
+*             task ready bits)
+*
+* @param[in]  ready_bits    the task bits input
+*
+* @return     LSB bit position or MSS_INVALID_TASK_ID if not bit is set
+*
+******************************************************************************/
+uint8_t mss_get_highest_prio_task(mss_task_bits_t ready_bits)
+{
+  if(ready_bits == 0)
+  {
+    return MSS_INVALID_TASK_ID;
+  }
+
+  return (uint8_t)__builtin_ctzl(ready_bits);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_posix_block_int
+*
+* @brief      save the signal mask and block the interrupt signals
+*
+* @param[out] int_flag   buffer for the signal mask
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_block_int(mss_int_flag_t* int_flag)
+{
+  pthread_sigmask(SIG_BLOCK, &int_sigs, int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_posix_restore_int
+*
+* @brief      restore the signal mask
+*
+* @param[in]  int_flag   signal mask saved by @ref mss_hal_posix_block_int
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_restore_int(const mss_int_flag_t* int_flag)
+{
+  pthread_sigmask(SIG_SETMASK, int_flag, NULL);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_posix_enable_int
+*
+* @brief      unblock the interrupt signals
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_enable_int(void)
+{
+  pthread_sigmask(SIG_UNBLOCK, &int_sigs, NULL);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_posix_wakeup
+*
+* @brief      let @ref mss_hal_sleep return after the current signal handler
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_wakeup(void)
+{
+  wakeup = 1;
+}
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+/**************************************************************************//**
+* 
+* tick_handler
+* 
+* @brief      SIGALRM handler, the MSS timer tick
+*
+* @param[in]  sig    signal number
+* 
+* @return     -
+* 
+******************************************************************************/
+static void tick_handler(int sig)
+{
+  (void)sig;
+
+  // increment mss timer tick
+  mss_timer_tick_cnt++;
+
+  if(delay_timer_cnt)
+  {
+    // decrement counter
+    delay_timer_cnt--;
+  }
+
+  if(delay_timer_cnt == 0)
+  {
+    // wake up if MSS is in sleep mode
+    if(mss_timer_tick())
+    {
+      wakeup = 1;
+    }
+  }
+}
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* sw_int_handler
+*
+* @brief      SIGUSR1 handler, the software interrupt
+*
+* @param[in]  sig    signal number
+*
+* @return     -
+*
+******************************************************************************/
+static void sw_int_handler(int sig)
+{
+  (void)sig;
+
+  // enable interrupt
+  pthread_sigmask(SIG_UNBLOCK, &int_sigs, NULL);
+
+  // call the scheduler
+  mss_scheduler();
+}
+#endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+
+#endif /* defined(MSS_HAL_POSIX) */
@@ -0,0 +1,175 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_hal_posix.h
+* 
+* @brief    MSS host (POSIX) port specific header file
+* 
+* @version  0.2.1
+*
+* @remark   included by mss_hal.h instead of the MSP430 definitions if
+*           MSS_HAL_POSIX is defined (see host/Makefile)
+* 
+******************************************************************************/
+
+#ifndef _MSS_HAL_POSIX_H_
+#define _MSS_HAL_POSIX_H_
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include <signal.h>
+
+//*****************************************************************************
+// Global variable declarations 
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+#if (MSS_POWER_STATS == TRUE)
+#error MSS_POWER_STATS is not supported by the host port
+#endif
+
+/** mss_int_flag_t
+ *  interrupt flag buffer data type - the signal mask of the process. The
+ *  timer tick (SIGALRM) and the software interrupt (SIGUSR1) play the role
+ *  of the maskable interrupts.
+ */
+typedef sigset_t mss_int_flag_t;
+
+/** MSS_ENTER_CRITICAL_SECTION
+ *  macro function for entering critical section (saving the current signal
+ *  mask, and then blocking the interrupt signals)
+ */
+#define MSS_ENTER_CRITICAL_SECTION(int_flag)    do {                  \
+                               mss_hal_posix_block_int(&(int_flag));  \
+                               } while(0)
+
+/** MSS_LEAVE_CRITICAL_SECTION
+ *  macro function for leaving critical section (restoring the signal mask
+ *  from the last @ref MSS_ENTER_CRITICAL_SECTION
+ */
+#define MSS_LEAVE_CRITICAL_SECTION(int_flag)    do {                  \
+                               mss_hal_posix_restore_int(&(int_flag)); \
+                               }while(0)
+
+/** MSS_MALLOC
+ *  macro function for dynamic memory allocation
+ */
+#define MSS_MALLOC(x)                   malloc(x)
+
+/** MSS_FREE
+ *  macro function for dynamic memory deallocation
+ */
+#define MSS_FREE(x)                     free(x)
+
+#if (MSS_TASK_USE_TIMER == TRUE)
+/** MSS_TIMER_TICK_MS
+ *  time for one MSS timer tick in milliseconds (period of the POSIX timer)
+ */
+#define MSS_TIMER_TICK_MS              (1)
+#endif
+
+#if (MSS_TASK_STATS == TRUE) || (MSS_TRACE == TRUE) || \
+    (MSS_LATENCY_STATS == TRUE)
+/** MSS_TIMESTAMP_US
+ *  time for one timestamp count of @ref mss_hal_get_timestamp in
+ *  microseconds (CLOCK_MONOTONIC)
+ */
+#define MSS_TIMESTAMP_US               (1)
+#endif
+
+/** MSS_HAL_WAKEUP_FROM_ISR
+ *  wake up the MSS from sleep mode at the end of a signal handler which
+ *  plays the role of an interrupt service routine
+ */
+#define MSS_HAL_WAKEUP_FROM_ISR(src)   mss_hal_posix_wakeup()
+
+//*****************************************************************************
+// External function declarations
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_hal_posix_block_int
+*
+* @brief      save the signal mask and block the interrupt signals
+*
+* @param[out] int_flag   buffer for the signal mask
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_block_int(mss_int_flag_t* int_flag);
+
+/**************************************************************************//**
+*
+* mss_hal_posix_restore_int
+*
+* @brief      restore the signal mask
+*
+* @param[in]  int_flag   signal mask saved by @ref mss_hal_posix_block_int
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_restore_int(const mss_int_flag_t* int_flag);
+
+/**************************************************************************//**
+*
+* mss_hal_posix_enable_int
+*
+* @brief      unblock the interrupt signals
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_enable_int(void);
+
+/**************************************************************************//**
+*
+* mss_hal_posix_wakeup
+*
+* @brief      let @ref mss_hal_sleep return after the current signal handler
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_posix_wakeup(void);
+
+#endif /* _MSS_HAL_POSIX_H_*/
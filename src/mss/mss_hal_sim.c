@@ -0,0 +1,758 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_hal_sim.c
+* 
+* @brief    mcu simple scheduler HAL (hardware abstraction layer) module for
+*           deterministic virtual-time simulation on the host
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_HAL_SIM is
+*           defined. There are no real interrupts: the tasks run in zero
+*           virtual time, mss_hal_sleep advances the virtual clock directly
+*           to the next timer deadline or scripted interrupt, updates
+*           mss_timer_tick_cnt by the elapsed ticks and calls
+*           mss_timer_tick() once, like the MSP430 HAL does when its sleep
+*           delay counter runs out. mss_run runs on a stack of its own,
+*           which is suspended at the end of mss_hal_sim_run and
+*           continued by the next one, like a halted MCU.
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "mss.h"
+#include "mss_int.h"
+
+#if defined(MSS_HAL_SIM)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+// simulated global interrupt enable
+uint8_t mss_hal_sim_gie = 0;
+
+// set by an interrupt to let mss_hal_sleep return
+uint8_t mss_hal_sim_wakeup = 0;
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+/** SIM_NEVER
+ *  virtual time of an event which never happens
+ */
+#define SIM_NEVER                (UINT64_MAX)
+
+/** SIM_STACK_SIZE
+ *  stack size of mss_run (tasks and service routines)
+ */
+#define SIM_STACK_SIZE           (64 * 1024)
+
+/** sim_irq_t
+ *  scripted interrupt
+ */
+typedef struct {
+  uint64_t tick;
+  uint8_t irq;
+  uint16_t arg;
+} sim_irq_t;
+
+// virtual time in ticks since mss_hal_init
+static uint64_t sim_time = 0;
+
+// end of the current mss_hal_sim_run
+static uint64_t sim_end_time = 0;
+
+// context of mss_run and of the caller of mss_hal_sim_run, the stack of
+// mss_run and whether mss_run has been started since mss_hal_init
+static ucontext_t sim_mcu_ctx;
+static ucontext_t sim_run_ctx;
+static void* sim_stack = NULL;
+static uint8_t sim_started = 0;
+
+// number of wake-ups from sleep
+static uint32_t sim_wakeups = 0;
+
+// set while a task polls in mss_hal_sim_poll, the CPU does not sleep then
+static uint8_t sim_polling = 0;
+
+#if (MSS_POWER_STATS == TRUE)
+// idle/sleep statistics
+static mss_power_stats_t power_stats;
+
+// set while the MSS sleeps in mss_hal_sleep until the first wake-up source
+// has been recorded
+static uint8_t power_sleeping = 0;
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+// scripted interrupts sorted by time, and the next one to be served
+static sim_irq_t* irq_tbl = NULL;
+static uint32_t irq_tbl_size = 0;
+static uint32_t num_of_irq = 0;
+static uint32_t next_irq = 0;
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+// software interrupt flag
+static uint8_t sw_int_pending = 0;
+#endif
+
+// service routines of the interrupt lines
+static mss_hal_sim_isr_t isr_tbl[MSS_HAL_SIM_NUM_OF_IRQ];
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+static void sim_pass_time(uint64_t time);
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+static void sw_int_isr(void);
+#endif
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_hal_init
+*
+* @brief      initialize mss HAL unit: reset the virtual clock
+*
+* @param      -
+*
+* @return     -
+*
+* @remark     loaded scripted interrupts and installed service routines are
+*             kept, so they can be set up before or after mss_init
+*
+******************************************************************************/
+void mss_hal_init(void)
+{
+  // "global interrupt disabled" after reset
+  mss_hal_sim_gie = 0;
+  mss_hal_sim_wakeup = 0;
+
+  sim_time = 0;
+  sim_wakeups = 0;
+  next_irq = 0;
+
+#if (MSS_POWER_STATS == TRUE)
+  memset(&power_stats, 0, sizeof(power_stats));
+  power_sleeping = 0;
+#endif
+
+  // mss_run starts from the beginning on the next mss_hal_sim_run
+  sim_started = 0;
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+  sw_int_pending = 0;
+#endif
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sleep
+*
+* @brief      advance the virtual clock to the next timer deadline or
+*             scripted interrupt and serve it. Returns to the caller of
+*             @ref mss_hal_sim_run if the next event is after the end of the
+*             run or there is no event left, and continues on the next run.
+*
+* @param[in]  sleep_timeout   ticks until the next timer deadline (if
+*                             MSS_SLEEP_NO_TIMEOUT, no timer is running)
+*
+* @return     -
+*
+* @remark     called with disabled interrupts
+*
+******************************************************************************/
+void mss_hal_sleep(mss_timer_tick_t sleep_timeout)
+{
+  uint64_t timer_time = SIM_NEVER;
+  uint64_t wake_time;
+  sim_irq_t* irq;
+
+  if(sleep_timeout != MSS_SLEEP_NO_TIMEOUT)
+  {
+    timer_time = sim_time + sleep_timeout;
+  }
+
+#if (MSS_POWER_STATS == TRUE)
+  power_sleeping = !sim_polling;
+#endif
+
+  while(1)
+  {
+    // the next event, an interrupt scheduled in the past is served now
+    wake_time = timer_time;
+    if((next_irq < num_of_irq) && (irq_tbl[next_irq].tick < wake_time))
+    {
+      wake_time = (irq_tbl[next_irq].tick > sim_time) ?
+                  irq_tbl[next_irq].tick : sim_time;
+    }
+
+    if(wake_time <= sim_end_time)
+    {
+      break;
+    }
+
+    if(wake_time != SIM_NEVER)
+    {
+      // sleep until the end of the run
+      sim_pass_time(sim_end_time);
+    }
+
+    // halt until the next run, which may have injected interrupts
+    swapcontext(&sim_mcu_ctx, &sim_run_ctx);
+  }
+
+  // jump to the wake-up time
+  sim_pass_time(wake_time);
+  mss_hal_sim_wakeup = 0;
+
+  if(wake_time == timer_time)
+  {
+    // timer deadline, processed before interrupts of the same tick
+    if(mss_timer_tick())
+    {
+      MSS_HAL_WAKEUP_FROM_ISR(MSS_WAKE_SRC_TIMER);
+    }
+  }
+
+  // serve the scripted interrupts of this tick
+  while((next_irq < num_of_irq) && (irq_tbl[next_irq].tick <= sim_time))
+  {
+    irq = &irq_tbl[next_irq++];
+    if(isr_tbl[irq->irq] != NULL)
+    {
+      isr_tbl[irq->irq](irq->arg);
+    }
+  }
+
+  if(mss_hal_sim_wakeup)
+  {
+    sim_wakeups++;
+
+  #if (MSS_POWER_STATS == TRUE)
+    if(!sim_polling)
+    {
+      if(power_sleeping)
+      {
+        // the waking interrupt did not tell its source
+        mss_hal_note_wakeup(MSS_WAKE_SRC_OTHER);
+      }
+      power_stats.wake_cnt++;
+    }
+  #endif /* (MSS_POWER_STATS == TRUE) */
+  }
+}
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* mss_hal_trigger_sw_int
+*
+* @brief      trigger software interrupt - served when the interrupts get
+*             enabled
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_trigger_sw_int(void)
+{
+  sw_int_pending = 1;
+
+  if(mss_hal_sim_gie)
+  {
+    sw_int_isr();
+  }
+}
+#endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+
+#if defined(MSS_TIMESTAMP_US)
+/**************************************************************************//**
+*
+* mss_hal_get_timestamp
+*
+* @brief      read the free-running timestamp counter (one count is
+*             @ref MSS_TIMESTAMP_US microseconds of host time)
+*
+* @param      -
+*
+* @return     current timestamp counter value
+*
+******************************************************************************/
+uint16_t mss_hal_get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint16_t)((ts.tv_sec * 1000000L) + (ts.tv_nsec / 1000));
+}
+#endif /* defined(MSS_TIMESTAMP_US) */
+
+/**************************************************************************//**
+*
+* mss_get_highest_prio_task
+*
+* @brief      get the highest priority task (LSB bit position of the
+*             task ready bits)
+*
+* @param[in]  ready_bits    the task bits input
+*
+* @return     LSB bit position or MSS_INVALID_TASK_ID if not bit is set
+*
+******************************************************************************/
+uint8_t mss_get_highest_prio_task(mss_task_bits_t ready_bits)
+{
+  if(ready_bits == 0)
+  {
+    return MSS_INVALID_TASK_ID;
+  }
+
+  return (uint8_t)__builtin_ctzl(ready_bits);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_restore_int
+*
+* @brief      restore the simulated global interrupt enable, runs a pending
+*             software interrupt if the interrupts get enabled
+*
+* @param[in]  int_flag   flag saved by @ref MSS_ENTER_CRITICAL_SECTION
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_sim_restore_int(mss_int_flag_t int_flag)
+{
+  mss_hal_sim_gie = int_flag;
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+  if(mss_hal_sim_gie && sw_int_pending)
+  {
+    sw_int_isr();
+  }
+#endif
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_set_isr
+*
+* @brief      install the service routine of a scripted interrupt line
+*
+* @param[in]  irq        interrupt line (< MSS_HAL_SIM_NUM_OF_IRQ)
+* @param[in]  isr        service routine, NULL to ignore the line
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_sim_set_isr(uint8_t irq, mss_hal_sim_isr_t isr)
+{
+  MSS_DEBUG_CHECK(irq < MSS_HAL_SIM_NUM_OF_IRQ);
+
+  isr_tbl[irq] = isr;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_load_script
+*
+* @brief      load scripted interrupts from a text file. Each line holds
+*             "<tick> <irq> [<arg>]" with the virtual time in ticks since
+*             mss_hal_init, the line is ignored after a '#'. The lines shall
+*             be sorted by time.
+*
+* @param[in]  path       file name
+*
+* @return     number of loaded interrupts, -1 if the file can not be read
+*             or holds an invalid line
+*
+******************************************************************************/
+int32_t mss_hal_sim_load_script(const char* path)
+{
+  FILE* file;
+  char line[128];
+  char* comment;
+  unsigned long long tick;
+  unsigned int irq, arg;
+  int32_t ret = 0;
+  int num;
+
+  file = fopen(path, "r");
+  if(file == NULL)
+  {
+    return -1;
+  }
+
+  while((ret >= 0) && (fgets(line, sizeof(line), file) != NULL))
+  {
+    comment = strchr(line, '#');
+    if(comment != NULL)
+    {
+      *comment = '\0';
+    }
+
+    arg = 0;
+    num = sscanf(line, "%llu %u %i", &tick, &irq, &arg);
+    if(num == EOF)
+    {
+      // empty line
+      continue;
+    }
+
+    if((num < 2) || (irq >= MSS_HAL_SIM_NUM_OF_IRQ) ||
+       (!mss_hal_sim_inject(tick, (uint8_t)irq, (uint16_t)arg)))
+    {
+      ret = -1;
+    }
+    else
+    {
+      ret++;
+    }
+  }
+
+  fclose(file);
+
+  return ret;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_inject
+*
+* @brief      schedule one interrupt, same as a script line
+*
+* @param[in]  tick       virtual time in ticks since mss_hal_init
+* @param[in]  irq        interrupt line
+* @param[in]  arg        argument for the service routine
+*
+* @return     true if success, false if the time is before the last
+*             scheduled interrupt or the interrupt table is full
+*
+******************************************************************************/
+bool mss_hal_sim_inject(uint64_t tick, uint8_t irq, uint16_t arg)
+{
+  sim_irq_t* tbl;
+
+  if((irq >= MSS_HAL_SIM_NUM_OF_IRQ) ||
+     ((num_of_irq > 0) && (tick < irq_tbl[num_of_irq - 1].tick)))
+  {
+    return false;
+  }
+
+  if(next_irq == num_of_irq)
+  {
+    // all interrupts served, reuse the table
+    next_irq = 0;
+    num_of_irq = 0;
+  }
+
+  if(num_of_irq == irq_tbl_size)
+  {
+    // grow the interrupt table
+    tbl = realloc(irq_tbl, (irq_tbl_size + 64) * 2 * sizeof(sim_irq_t));
+    if(tbl == NULL)
+    {
+      return false;
+    }
+    irq_tbl = tbl;
+    irq_tbl_size = (irq_tbl_size + 64) * 2;
+  }
+
+  irq_tbl[num_of_irq].tick = tick;
+  irq_tbl[num_of_irq].irq = irq;
+  irq_tbl[num_of_irq].arg = arg;
+  num_of_irq++;
+
+  return true;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_run
+*
+* @brief      run the MSS (@ref mss_run) until the virtual time reaches
+*             end_tick or nothing is left to wake it up
+*
+* @param[in]  end_tick   virtual time in ticks since mss_hal_init
+*
+* @return     virtual time at the end of the run
+*
+******************************************************************************/
+uint64_t mss_hal_sim_run(uint64_t end_tick)
+{
+  sim_end_time = end_tick;
+
+  if(!sim_started)
+  {
+    if(sim_stack == NULL)
+    {
+      sim_stack = malloc(SIM_STACK_SIZE);
+      MSS_DEBUG_CHECK(sim_stack != NULL);
+    }
+
+    getcontext(&sim_mcu_ctx);
+    sim_mcu_ctx.uc_stack.ss_sp = sim_stack;
+    sim_mcu_ctx.uc_stack.ss_size = SIM_STACK_SIZE;
+    sim_mcu_ctx.uc_link = NULL;
+    makecontext(&sim_mcu_ctx, mss_run, 0);
+    sim_started = 1;
+  }
+
+  // run (or continue) mss_run until it sleeps past the end of the run
+  swapcontext(&sim_run_ctx, &sim_mcu_ctx);
+
+  return sim_time;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_poll
+*
+* @brief      wait for the next timer deadline or scripted interrupt from a
+*             polling task (the idle loop of mss_run is not reached while
+*             the task runs)
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_sim_poll(void)
+{
+  mss_int_flag_t int_flag;
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  // the virtual time passes with running CPU
+  sim_polling = 1;
+#if (MSS_TASK_USE_TIMER == TRUE)
+  mss_hal_sleep(mss_timer_get_next_tick());
+#else
+  mss_hal_sleep(MSS_SLEEP_NO_TIMEOUT);
+#endif /* (MSS_TASK_USE_TIMER == TRUE) */
+  sim_polling = 0;
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_get_time
+*
+* @brief      get the virtual time
+*
+* @param      -
+*
+* @return     virtual time in ticks since mss_hal_init
+*
+******************************************************************************/
+uint64_t mss_hal_sim_get_time(void)
+{
+  return sim_time;
+}
+
+/**************************************************************************//**
+*
+* mss_hal_sim_get_wakeups
+*
+* @brief      get the number of wake-ups from sleep (timer and interrupts)
+*
+* @param      -
+*
+* @return     number of wake-ups
+*
+******************************************************************************/
+uint32_t mss_hal_sim_get_wakeups(void)
+{
+  return sim_wakeups;
+}
+
+#if (MSS_POWER_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_get_power_stats
+*
+* @brief      get a copy of the idle/sleep statistics
+*
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_get_power_stats(mss_power_stats_t* stats)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameter
+  MSS_DEBUG_CHECK(stats != NULL);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  *stats = power_stats;
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_reset_power_stats
+*
+* @brief      clear the idle/sleep statistics
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_reset_power_stats(void)
+{
+  mss_int_flag_t int_flag;
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  memset(&power_stats, 0, sizeof(power_stats));
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_hal_note_wakeup
+*
+* @brief      record the source of a wake-up if the MSS is sleeping - used by
+*             @ref MSS_HAL_WAKEUP_FROM_ISR
+*
+* @param[in]  src        one of the MSS_WAKE_SRC_xxx values
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_note_wakeup(uint8_t src)
+{
+  // check parameter
+  MSS_DEBUG_CHECK(src < MSS_NUM_OF_WAKE_SRC);
+
+  // only the first source ending the sleep counts, the service routines
+  // run with disabled interrupts
+  if(power_sleeping)
+  {
+    power_sleeping = 0;
+    power_stats.last_wake_src = src;
+    power_stats.wake_src_cnt[src]++;
+  }
+}
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* sim_pass_time
+*
+* @brief      advance the virtual clock and mss_timer_tick_cnt, the elapsed
+*             ticks count as sleep in LPM0, or as active time while a task
+*             polls
+*
+* @param[in]  time       new virtual time, not before the current one
+*
+* @return     -
+*
+******************************************************************************/
+static void sim_pass_time(uint64_t time)
+{
+  mss_timer_tick_cnt += (mss_timer_tick_t)(time - sim_time);
+
+#if (MSS_POWER_STATS == TRUE)
+  if(sim_polling)
+  {
+    power_stats.active_ticks += (uint32_t)(time - sim_time);
+  }
+  else
+  {
+    power_stats.sleep_ticks[0] += (uint32_t)(time - sim_time);
+  }
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+  sim_time = time;
+}
+
+#if (MSS_PREEMPTIVE_SCHEDULING == TRUE)
+/**************************************************************************//**
+*
+* sw_int_isr
+*
+* @brief      simulated software interrupt ISR
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+static void sw_int_isr(void)
+{
+  // clear flag
+  sw_int_pending = 0;
+
+  MSS_TRACE_RECORD(MSS_TRACE_EV_PREEMPT, mss_running_task_id);
+
+  // enable interrupt
+  mss_hal_sim_gie = 1;
+
+  // call the scheduler
+  mss_scheduler();
+
+#if (MSS_TRACE == TRUE)
+  // the preempted task continues after the return from interrupt
+  mss_hal_sim_gie = 0;
+  MSS_TRACE_RECORD(MSS_TRACE_EV_RESUME, mss_running_task_id);
+#endif
+
+  // interrupts enabled again by the return from interrupt
+  mss_hal_sim_gie = 1;
+}
+#endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
+
+#endif /* defined(MSS_HAL_SIM) */
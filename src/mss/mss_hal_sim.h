@@ -0,0 +1,338 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_hal_sim.h
+* 
+* @brief    MSS virtual-time simulation port specific header file
+* 
+* @version  0.2.1
+*
+* @remark   included by mss_hal.h instead of the MSP430 definitions if
+*           MSS_HAL_SIM is defined (see host/Makefile)
+* 
+******************************************************************************/
+
+#ifndef _MSS_HAL_SIM_H_
+#define _MSS_HAL_SIM_H_
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Global variable declarations 
+//*****************************************************************************
+
+// simulated global interrupt enable
+extern uint8_t mss_hal_sim_gie;
+
+// set by an interrupt to let mss_hal_sleep return
+extern uint8_t mss_hal_sim_wakeup;
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+#if (MSS_TASK_USE_TIMER == FALSE)
+#error the simulation port needs MSS_TASK_USE_TIMER
+#endif
+
+/** mss_int_flag_t
+ *  interrupt flag buffer data type - the simulated global interrupt enable
+ */
+typedef uint8_t mss_int_flag_t;
+
+/** MSS_ENTER_CRITICAL_SECTION
+ *  macro function for entering critical section (saving the simulated global
+ *  interrupt enable, and then clearing it)
+ */
+#define MSS_ENTER_CRITICAL_SECTION(int_flag)    do {                  \
+                               int_flag = mss_hal_sim_gie;            \
+                               mss_hal_sim_gie = 0;                   \
+                               } while(0)
+
+/** MSS_LEAVE_CRITICAL_SECTION
+ *  macro function for leaving critical section (restoring the simulated
+ *  global interrupt enable from the last @ref MSS_ENTER_CRITICAL_SECTION
+ */
+#define MSS_LEAVE_CRITICAL_SECTION(int_flag)    do {                  \
+                               mss_hal_sim_restore_int(int_flag);     \
+                               }while(0)
+
+/** MSS_MALLOC
+ *  macro function for dynamic memory allocation
+ */
+#define MSS_MALLOC(x)                   malloc(x)
+
+/** MSS_FREE
+ *  macro function for dynamic memory deallocation
+ */
+#define MSS_FREE(x)                     free(x)
+
+/** MSS_TIMER_TICK_MS
+ *  time for one MSS timer tick in milliseconds (one virtual clock count)
+ */
+#define MSS_TIMER_TICK_MS              (1)
+
+#if (MSS_TASK_STATS == TRUE) || (MSS_TRACE == TRUE) || \
+    (MSS_LATENCY_STATS == TRUE)
+/** MSS_TIMESTAMP_US
+ *  time for one timestamp count of @ref mss_hal_get_timestamp in
+ *  microseconds - host time, the tasks do not consume virtual time
+ */
+#define MSS_TIMESTAMP_US               (1)
+#endif
+
+#if (MSS_POWER_STATS == TRUE)
+/** MSS_POWER_TICK_US
+ *  time of one active/sleep tick of @ref mss_power_stats_t in microseconds
+ *  (one virtual clock count)
+ */
+#define MSS_POWER_TICK_US              (MSS_TIMER_TICK_MS * 1000)
+
+/** MSS_NUM_OF_LPM
+ *  number of low power modes, the same as on the MSP430 (the simulation
+ *  sleeps in LPM0 only)
+ */
+#define MSS_NUM_OF_LPM                 (5)
+
+/** MSS_WAKE_SRC_xxx
+ *  wake-up sources given to @ref MSS_HAL_WAKEUP_FROM_ISR
+ */
+#define MSS_WAKE_SRC_TIMER             (0)
+#define MSS_WAKE_SRC_UART              (1)
+#define MSS_WAKE_SRC_PORT              (2)
+#define MSS_WAKE_SRC_OTHER             (3)
+#define MSS_NUM_OF_WAKE_SRC            (4)
+
+/** mss_power_stats_t
+ *  idle/sleep statistics of the simulated device in virtual time
+ */
+typedef struct
+{
+  uint32_t active_ticks;                      /**< ticks with running CPU */
+  uint32_t sleep_ticks[MSS_NUM_OF_LPM];       /**< ticks in each LPM */
+  uint16_t wake_cnt;                          /**< number of wake-ups */
+  uint16_t wake_src_cnt[MSS_NUM_OF_WAKE_SRC]; /**< wake-ups per source */
+  uint8_t last_wake_src;                      /**< source of last wake-up */
+} mss_power_stats_t;
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+/** MSS_HAL_WAKEUP_FROM_ISR
+ *  wake up the MSS from sleep mode at the end of a scripted interrupt. The
+ *  source is one of the MSS_WAKE_SRC_xxx values and only used if
+ *  MSS_POWER_STATS is TRUE.
+ */
+#if (MSS_POWER_STATS == TRUE)
+#define MSS_HAL_WAKEUP_FROM_ISR(src)   do {                   \
+                               mss_hal_note_wakeup(src);      \
+                               mss_hal_sim_wakeup = 1;        \
+                               } while(0)
+#else
+#define MSS_HAL_WAKEUP_FROM_ISR(src)   do {                   \
+                               mss_hal_sim_wakeup = 1;        \
+                               } while(0)
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+/** MSS_HAL_SIM_NUM_OF_IRQ
+ *  number of scripted interrupt lines
+ */
+#define MSS_HAL_SIM_NUM_OF_IRQ         (8)
+
+/** mss_hal_sim_isr_t
+ *  scripted interrupt service routine, gets the argument of the script line
+ */
+typedef void (*mss_hal_sim_isr_t)(uint16_t arg);
+
+//*****************************************************************************
+// External function declarations
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_hal_sim_restore_int
+*
+* @brief      restore the simulated global interrupt enable, runs a pending
+*             software interrupt if the interrupts get enabled
+*
+* @param[in]  int_flag   flag saved by @ref MSS_ENTER_CRITICAL_SECTION
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_sim_restore_int(mss_int_flag_t int_flag);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_set_isr
+*
+* @brief      install the service routine of a scripted interrupt line
+*
+* @param[in]  irq        interrupt line (< MSS_HAL_SIM_NUM_OF_IRQ)
+* @param[in]  isr        service routine, NULL to ignore the line
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_sim_set_isr(uint8_t irq, mss_hal_sim_isr_t isr);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_load_script
+*
+* @brief      load scripted interrupts from a text file. Each line holds
+*             "<tick> <irq> [<arg>]" with the virtual time in ticks since
+*             mss_hal_init, the line is ignored after a '#'. The lines shall
+*             be sorted by time.
+*
+* @param[in]  path       file name
+*
+* @return     number of loaded interrupts, -1 if the file can not be read
+*             or holds an invalid line
+*
+******************************************************************************/
+int32_t mss_hal_sim_load_script(const char* path);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_inject
+*
+* @brief      schedule one interrupt, same as a script line
+*
+* @param[in]  tick       virtual time in ticks since mss_hal_init
+* @param[in]  irq        interrupt line
+* @param[in]  arg        argument for the service routine
+*
+* @return     true if success, false if the time is before the last
+*             scheduled interrupt or the interrupt table is full
+*
+******************************************************************************/
+bool mss_hal_sim_inject(uint64_t tick, uint8_t irq, uint16_t arg);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_run
+*
+* @brief      run the MSS (@ref mss_run) until the virtual time reaches
+*             end_tick or nothing is left to wake it up. The MSS is halted
+*             in sleep and continued by the next call.
+*
+* @param[in]  end_tick   virtual time in ticks since mss_hal_init
+*
+* @return     virtual time at the end of the run
+*
+******************************************************************************/
+uint64_t mss_hal_sim_run(uint64_t end_tick);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_poll
+*
+* @brief      wait for the next timer deadline or scripted interrupt from a
+*             task that polls a device register instead of returning (the
+*             idle loop of mss_run is not reached while the task runs)
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_sim_poll(void);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_get_time
+*
+* @brief      get the virtual time
+*
+* @param      -
+*
+* @return     virtual time in ticks since mss_hal_init
+*
+******************************************************************************/
+uint64_t mss_hal_sim_get_time(void);
+
+/**************************************************************************//**
+*
+* mss_hal_sim_get_wakeups
+*
+* @brief      get the number of wake-ups from sleep (timer and interrupts)
+*
+* @param      -
+*
+* @return     number of wake-ups
+*
+******************************************************************************/
+uint32_t mss_hal_sim_get_wakeups(void);
+
+#if (MSS_POWER_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_get_power_stats
+*
+* @brief      get a copy of the idle/sleep statistics
+*
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_get_power_stats(mss_power_stats_t* stats);
+
+/**************************************************************************//**
+*
+* mss_reset_power_stats
+*
+* @brief      clear the idle/sleep statistics
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_reset_power_stats(void);
+
+/**************************************************************************//**
+*
+* mss_hal_note_wakeup
+*
+* @brief      record the source of a wake-up if the MSS is sleeping - used by
+*             @ref MSS_HAL_WAKEUP_FROM_ISR
+*
+* @param[in]  src        one of the MSS_WAKE_SRC_xxx values
+*
+* @return     -
+*
+******************************************************************************/
+void mss_hal_note_wakeup(uint8_t src);
+#endif /* (MSS_POWER_STATS == TRUE) */
+
+#endif /* _MSS_HAL_SIM_H_*/
@@ -100,6 +100,36 @@ typedef uint32_t mss_task_bits_t;
 }
 #endif
 
+/** MSS_TASK_PRIO_LEVEL
+ *  priority level of a task id (lower level means higher priority)
+ */
+#define MSS_TASK_PRIO_LEVEL(task_id)    ((task_id) / MSS_TASKS_PER_PRIO_LEVEL)
+
+/** MSS_PRIO_LEVEL_FIRST_TASK
+ *  task id of the first task in the priority level of a task id
+ */
+#define MSS_PRIO_LEVEL_FIRST_TASK(task_id)                                    \
+        ((task_id) & ~(MSS_TASKS_PER_PRIO_LEVEL - 1))
+
+#if (MSS_EDF_SCHEDULING == TRUE) && ((MSS_TASK_USE_TIMER != TRUE) || \
+                                     (MSS_TASKS_PER_PRIO_LEVEL > 1))
+#error MSS_EDF_SCHEDULING needs the timer module and no priority levels
+#endif
+
+#if (MSS_LATENCY_STATS == TRUE) && \
+    ((MSS_LATENCY_BUCKET_BASE << (MSS_LATENCY_NUM_OF_BUCKETS - 2)) > 0x8000)
+#error MSS_LATENCY_BUCKET_BASE too large for MSS_LATENCY_NUM_OF_BUCKETS
+#endif
+
+#if (MSS_POWER_STATS == TRUE) && (MSS_TASK_USE_TIMER != TRUE)
+#error MSS_POWER_STATS needs the timer module
+#endif
+
+#if ((MSS_TASKS_PER_PRIO_LEVEL & (MSS_TASKS_PER_PRIO_LEVEL - 1)) != 0) || \
+    (MSS_TASKS_PER_PRIO_LEVEL > 32)
+#error MSS_TASKS_PER_PRIO_LEVEL shall be a power of two up to 32
+#endif
+
 //*****************************************************************************
 // Global variable declarations 
 //*****************************************************************************
@@ -137,21 +167,11 @@ extern mss_timer_tick_t mss_timer_tick_cnt;
 // Macros (defines) and data types 
 //*****************************************************************************
 
-/** mss_task_t
- *  mss task data type
- */ 
-typedef void (*mss_task_t) (void*);
-
 /** mss_tcb_t
  *  mss task control block data type
  */
 typedef struct _mss_tcb_t  mss_tcb_t;
 
-/** MSS_INVALID_TASK_ID
- *  invalid task id
- */
-#define MSS_INVALID_TASK_ID            (0xFF)
-
 /** MSS_SLEEP_NO_TIMEOUT
  *  sleep without timeout
  */
@@ -166,6 +186,16 @@ typedef struct _mss_tcb_t  mss_tcb_t;
 #define MSS_DEBUG_CHECK(cond)
 #endif /* (MSS_DEBUG_MODE == TRUE) */
 
+/** MSS_TRACE_RECORD
+ *  write a scheduler event into the trace ring (only if MSS_TRACE is TRUE,
+ *  shall be used with disabled interrupt)
+ */
+#if (MSS_TRACE == TRUE)
+#define MSS_TRACE_RECORD(event, task_id)   mss_trace_record(event, task_id)
+#else
+#define MSS_TRACE_RECORD(event, task_id)
+#endif /* (MSS_TRACE == TRUE) */
+
 //*****************************************************************************
 // External function declarations
 //*****************************************************************************
@@ -241,6 +271,37 @@ mss_timer_tick_t mss_timer_get_next_tick(void);
 void mss_event_init(void);
 #endif /* (MSS_TASK_USE_EVENT == TRUE) */
 
+#if (MSS_LATENCY_STATS == TRUE)
+/**************************************************************************//**
+*
+* mss_latency_init
+*
+* @brief      initialize latency module
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_init(void);
+
+/**************************************************************************//**
+*
+* mss_latency_task_start
+*
+* @brief      finish the pending measurement of a task which is started by
+*             the scheduler
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+* @remark     shall be called with disabled interrupt
+*
+******************************************************************************/
+void mss_latency_task_start(uint8_t task_id);
+#endif /* (MSS_LATENCY_STATS == TRUE) */
+
 /**************************************************************************//**
 *
 * mss_get_highest_prio_task
@@ -273,6 +334,20 @@ uint8_t mss_get_highest_prio_task(mss_task_bits_t ready_bits);
 ******************************************************************************/
 void mss_activate_task_int(uint8_t task_id);
 
+/**************************************************************************//**
+*
+* mss_activate_tasks_int
+*
+* @brief      internal MSS function to put several tasks into active state
+*             with a single update of the ready bits - not reentrant
+*
+* @param[in]  task_bits    bits of the tasks to be activated
+*
+* @return     -
+*
+******************************************************************************/
+void mss_activate_tasks_int(mss_task_bits_t task_bits);
+
 /**************************************************************************//**
 *
 * mss_hal_init
@@ -334,4 +409,39 @@ void mss_hal_sleep(mss_timer_tick_t sleep_timeout);
 void mss_hal_trigger_sw_int(void);
 #endif /* (MSS_PREEMPTIVE_SCHEDULING == TRUE) */
 
+#if defined(MSS_TIMESTAMP_US)
+/**************************************************************************//**
+*
+* mss_hal_get_timestamp
+*
+* @brief      read the free-running timestamp counter (one count is
+*             @ref MSS_TIMESTAMP_US microseconds)
+*
+* @param      -
+*
+* @return     current timestamp counter value
+*
+******************************************************************************/
+uint16_t mss_hal_get_timestamp(void);
+#endif /* defined(MSS_TIMESTAMP_US) */
+
+#if (MSS_TRACE == TRUE)
+/**************************************************************************//**
+*
+* mss_trace_record
+*
+* @brief      write a record into the trace ring, overwriting the oldest
+*             record if the ring is full
+*
+* @param[in]  event      one of the MSS_TRACE_EV_xxx values
+* @param[in]  task_id    task id the event belongs to
+*
+* @return     -
+*
+* @remark     shall be called with disabled interrupt
+*
+******************************************************************************/
+void mss_trace_record(uint8_t event, uint8_t task_id);
+#endif /* (MSS_TRACE == TRUE) */
+
 #endif /* _MSS_INT_H_*/
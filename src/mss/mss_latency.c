@@ -0,0 +1,306 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_latency.c
+* 
+* @brief    mcu simple scheduler interrupt-to-task latency module
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_LATENCY_STATS
+*           defined as TRUE
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "mss.h"
+#include "mss_int.h"
+
+#if (MSS_LATENCY_STATS == TRUE)
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+/** mss_latency_stats
+ *  latency statistics of each interrupt source
+ */
+mss_latency_stats_t mss_latency_stats[MSS_LATENCY_NUM_OF_SRC];
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+/** LATENCY_NO_SRC
+ *  no pending measurement for a task
+ */
+#define LATENCY_NO_SRC            (0xFF)
+
+// interrupt source of the pending measurement of each task
+static uint8_t pending_src[MSS_NUM_OF_TASKS];
+
+// ISR entry timestamp of each interrupt source
+static uint16_t isr_entry_time[MSS_LATENCY_NUM_OF_SRC];
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+static void latency_clear(uint8_t src);
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_latency_init
+*
+* @brief      initialize latency module
+*
+* @param      -
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_init(void)
+{
+  uint8_t i;
+
+  for(i=0 ; i<MSS_NUM_OF_TASKS ; i++)
+  {
+    pending_src[i] = LATENCY_NO_SRC;
+  }
+
+  for(i=0 ; i<MSS_LATENCY_NUM_OF_SRC ; i++)
+  {
+    latency_clear(i);
+  }
+}
+
+/**************************************************************************//**
+*
+* mss_latency_isr_entry
+*
+* @brief      bind the entry timestamp of an ISR to the task which the ISR
+*             activates. If the task has already a pending measurement, the
+*             older ISR entry is kept.
+*
+* @param[in]  src        interrupt source (0 .. MSS_LATENCY_NUM_OF_SRC-1)
+* @param[in]  task_id    task id number of the task activated by the ISR
+* @param[in]  entry_time timestamp taken first thing in the ISR
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_isr_entry(uint8_t src, uint8_t task_id, uint16_t entry_time)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameters
+  MSS_DEBUG_CHECK(src < MSS_LATENCY_NUM_OF_SRC);
+  MSS_DEBUG_CHECK(task_id < MSS_NUM_OF_TASKS);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  if(pending_src[task_id] == LATENCY_NO_SRC)
+  {
+    pending_src[task_id] = src;
+    isr_entry_time[src] = entry_time;
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_latency_isr_stamp
+*
+* @brief      read the timestamp counter for the entry of an ISR
+*
+* @param      -
+*
+* @return     current timestamp counter value
+*
+******************************************************************************/
+uint16_t mss_latency_isr_stamp(void)
+{
+  return mss_hal_get_timestamp();
+}
+
+/**************************************************************************//**
+*
+* mss_latency_task_start
+*
+* @brief      finish the pending measurement of a task which is started by
+*             the scheduler
+*
+* @param[in]  task_id    task id number
+*
+* @return     -
+*
+* @remark     shall be called with disabled interrupt
+*
+******************************************************************************/
+void mss_latency_task_start(uint8_t task_id)
+{
+  uint8_t src, bucket;
+  uint16_t latency;
+  mss_latency_stats_t* stats;
+
+  src = pending_src[task_id];
+  if(src != LATENCY_NO_SRC)
+  {
+    pending_src[task_id] = LATENCY_NO_SRC;
+
+    latency = mss_hal_get_timestamp() - isr_entry_time[src];
+    stats = &mss_latency_stats[src];
+
+    if(latency < stats->min)
+    {
+      stats->min = latency;
+    }
+    if(latency > stats->max)
+    {
+      stats->max = latency;
+    }
+    stats->sum += latency;
+    stats->cnt++;
+
+    // logarithmic buckets
+    for(bucket=0 ; bucket<(MSS_LATENCY_NUM_OF_BUCKETS-1) ; bucket++)
+    {
+      if(latency < ((uint16_t)MSS_LATENCY_BUCKET_BASE << bucket))
+      {
+        break;
+      }
+    }
+    stats->hist[bucket]++;
+  }
+}
+
+/**************************************************************************//**
+*
+* mss_latency_get_stats
+*
+* @brief      get a copy of the latency statistics of an interrupt source
+*
+* @param[in]  src        interrupt source
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_get_stats(uint8_t src, mss_latency_stats_t* stats)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameters
+  MSS_DEBUG_CHECK(src < MSS_LATENCY_NUM_OF_SRC);
+  MSS_DEBUG_CHECK(stats != NULL);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  *stats = mss_latency_stats[src];
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_latency_get_avg
+*
+* @brief      get the average latency of an interrupt source
+*
+* @param[in]  src        interrupt source
+*
+* @return     average latency in timestamp counts, 0 if nothing measured
+*
+******************************************************************************/
+uint16_t mss_latency_get_avg(uint8_t src)
+{
+  mss_latency_stats_t stats;
+
+  mss_latency_get_stats(src, &stats);
+
+  if(stats.cnt == 0)
+  {
+    return 0;
+  }
+
+  return (uint16_t)(stats.sum / stats.cnt);
+}
+
+/**************************************************************************//**
+*
+* mss_latency_reset
+*
+* @brief      clear the latency statistics of an interrupt source
+*
+* @param[in]  src        interrupt source
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_reset(uint8_t src)
+{
+  mss_int_flag_t int_flag;
+
+  // check parameter
+  MSS_DEBUG_CHECK(src < MSS_LATENCY_NUM_OF_SRC);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+  latency_clear(src);
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* latency_clear
+*
+* @brief      clear the latency statistics of an interrupt source
+*
+* @param[in]  src        interrupt source
+*
+* @return     -
+*
+******************************************************************************/
+static void latency_clear(uint8_t src)
+{
+  memset(&mss_latency_stats[src], 0, sizeof(mss_latency_stats_t));
+  mss_latency_stats[src].min = 0xFFFF;
+}
+
+#endif /* (MSS_LATENCY_STATS == TRUE) */
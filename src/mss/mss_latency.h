@@ -0,0 +1,201 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_latency.h
+* 
+* @brief    mcu simple scheduler interrupt-to-task latency module header file
+* 
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_LATENCY_STATS
+*           defined as TRUE
+* 
+******************************************************************************/
+
+#ifndef _MSS_LATENCY_H_
+#define _MSS_LATENCY_H_
+
+/**
+ * @ingroup   MSS_API
+ * @defgroup  MSS_Latency_API  MSS Latency API
+ * @brief     MSS interrupt-to-task latency measurement API definitions, data
+ *            types, and functions (enabled only if
+ *            (MSS_LATENCY_STATS == TRUE))
+ * @{
+ */
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+/**
+ * @name MSS Latency Statistics
+ * @{
+ */
+
+/** mss_latency_stats_t
+ *  latency statistics of one interrupt source, all times in timestamp
+ *  counts (see @ref MSS_TIMESTAMP_US). Bucket i of the histogram counts the
+ *  latencies below (MSS_LATENCY_BUCKET_BASE << i), the last bucket counts
+ *  all longer latencies.
+ */
+typedef struct
+{
+  uint16_t min;                               /**< shortest latency */
+  uint16_t max;                               /**< longest latency */
+  uint32_t sum;                               /**< sum of all latencies */
+  uint16_t cnt;                               /**< number of measurements */
+  uint16_t hist[MSS_LATENCY_NUM_OF_BUCKETS];  /**< histogram buckets */
+} mss_latency_stats_t;
+
+/** MSS_LATENCY_ISR_ENTRY
+ *  macro function to be placed at the very beginning of an ISR which
+ *  activates a task: the latency from here to the next start of the task
+ *  is measured for the interrupt source
+ */
+#define MSS_LATENCY_ISR_ENTRY(src, task_id)                                   \
+        mss_latency_isr_entry(src, task_id, mss_latency_isr_stamp())
+
+/** MSS_LATENCY_ISR_STAMP
+ *  macro function to be placed at the very beginning of an ISR which
+ *  activates a task only in some cases: declares the variable stamp with
+ *  the ISR entry timestamp, see @ref MSS_LATENCY_ISR_RECORD
+ */
+#define MSS_LATENCY_ISR_STAMP(stamp)                                          \
+        uint16_t stamp = mss_latency_isr_stamp()
+
+/** MSS_LATENCY_ISR_RECORD
+ *  macro function to bind the ISR entry timestamp stamp of
+ *  @ref MSS_LATENCY_ISR_STAMP to the task which the ISR activates
+ */
+#define MSS_LATENCY_ISR_RECORD(src, task_id, stamp)                           \
+        mss_latency_isr_entry(src, task_id, stamp)
+
+/** @} MSS Latency Statistics */
+
+//*****************************************************************************
+// Global variable declarations 
+//*****************************************************************************
+
+/** mss_latency_stats
+ *  latency statistics of each interrupt source - global to be readable by
+ *  debuggers and simulator scripts (see tools/latency_bench.py)
+ */
+extern mss_latency_stats_t mss_latency_stats[MSS_LATENCY_NUM_OF_SRC];
+
+//*****************************************************************************
+// External function declarations
+//*****************************************************************************
+
+/**
+ * @name MSS Latency API Functions
+ * @{
+ */
+
+/**************************************************************************//**
+*
+* mss_latency_isr_entry
+*
+* @brief      bind the entry timestamp of an ISR to the task which the ISR
+*             activates. If the task has already a pending measurement, the
+*             older ISR entry is kept.
+*
+* @param[in]  src        interrupt source (0 .. MSS_LATENCY_NUM_OF_SRC-1)
+* @param[in]  task_id    task id number of the task activated by the ISR
+* @param[in]  entry_time timestamp taken first thing in the ISR
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_isr_entry(uint8_t src, uint8_t task_id, uint16_t entry_time);
+
+/**************************************************************************//**
+*
+* mss_latency_isr_stamp
+*
+* @brief      read the timestamp counter for the entry of an ISR
+*
+* @param      -
+*
+* @return     current timestamp counter value
+*
+******************************************************************************/
+uint16_t mss_latency_isr_stamp(void);
+
+/**************************************************************************//**
+*
+* mss_latency_get_stats
+*
+* @brief      get a copy of the latency statistics of an interrupt source
+*
+* @param[in]  src        interrupt source
+* @param[out] stats      buffer for the statistics
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_get_stats(uint8_t src, mss_latency_stats_t* stats);
+
+/**************************************************************************//**
+*
+* mss_latency_get_avg
+*
+* @brief      get the average latency of an interrupt source
+*
+* @param[in]  src        interrupt source
+*
+* @return     average latency in timestamp counts, 0 if nothing measured
+*
+******************************************************************************/
+uint16_t mss_latency_get_avg(uint8_t src);
+
+/**************************************************************************//**
+*
+* mss_latency_reset
+*
+* @brief      clear the latency statistics of an interrupt source
+*
+* @param[in]  src        interrupt source
+*
+* @return     -
+*
+******************************************************************************/
+void mss_latency_reset(uint8_t src);
+
+/** @} MSS Latency API Functions */
+
+/** @} MSS_Latency_API */
+
+#endif /* _MSS_LATENCY_H_*/
@@ -0,0 +1,328 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_rwlock.c
+* 
+* @brief    mcu simple scheduler reader-writer lock module
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_TASK_USE_RWLOCK
+*           defined as TRUE
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "mss.h"
+#include "mss_int.h"
+
+#if (MSS_TASK_USE_RWLOCK == TRUE)
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+/** mss_rwlock_tbl_t
+ *  mss reader-writer lock table data type
+ */
+struct mss_rwlock_tbl_t{
+  mss_task_bits_t reading_tasks;
+  mss_task_bits_t waiting_readers;
+  mss_task_bits_t waiting_writers;
+  uint8_t writing_task;
+};
+
+// number of created reader-writer locks
+static uint8_t num_of_rwlock = 0;
+
+// reader-writer lock table
+static struct mss_rwlock_tbl_t rwlock_tbl[MSS_MAX_NUM_OF_RWLOCK];
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+static void rwlock_wake_writer(mss_rwlock_t hdl);
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_rwlock_create
+*
+* @brief      create a new reader-writer lock
+*
+* @param      -
+*
+* @return     handle to created lock, MSS_RWLOCK_INVALID_HDL if failure
+*
+******************************************************************************/
+mss_rwlock_t mss_rwlock_create(void)
+{
+  mss_rwlock_t ret_hdl = MSS_RWLOCK_INVALID_HDL;
+
+  // check if there is a free reader-writer lock block
+  if(num_of_rwlock < MSS_MAX_NUM_OF_RWLOCK)
+  {
+    // set initialization value of the lock block
+    rwlock_tbl[num_of_rwlock].reading_tasks = 0;
+    rwlock_tbl[num_of_rwlock].waiting_readers = 0;
+    rwlock_tbl[num_of_rwlock].waiting_writers = 0;
+    rwlock_tbl[num_of_rwlock].writing_task = MSS_INVALID_TASK_ID;
+
+    // return handle and increment number of lock block
+    ret_hdl = &rwlock_tbl[num_of_rwlock++];
+  }
+
+  return ret_hdl;
+}
+
+/**************************************************************************//**
+*
+* mss_rwlock_read_lock
+*
+* @brief      lock a reader-writer lock for reading. Any number of tasks can
+*             hold the read lock at the same time. Writers are preferred:
+*             the read lock is refused as long as a writer holds the lock or
+*             is waiting for it, and the task will be put into the waiting
+*             reader list.
+*
+* @param[in]  hdl        reader-writer lock handle
+*
+* @return     if true the read lock is held, if false the lock is not
+*             available
+*
+******************************************************************************/
+bool mss_rwlock_read_lock(mss_rwlock_t hdl)
+{
+  bool ret = false;
+  mss_task_bits_t task_bit;
+  mss_int_flag_t int_flag;
+
+  // check handle
+  MSS_DEBUG_CHECK(hdl != MSS_RWLOCK_INVALID_HDL);
+
+  // turn running task id into bit position
+  task_bit = mss_bitpos_to_bit[mss_running_task_id];
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  if(hdl->reading_tasks & task_bit)
+  {
+    // task already holds the read lock
+    ret = true;
+  }
+  else if((hdl->writing_task == MSS_INVALID_TASK_ID) &&
+          (hdl->waiting_writers == 0))
+  {
+    // no writer is active or waiting, join the readers
+    hdl->reading_tasks |= task_bit;
+    hdl->waiting_readers &= ~task_bit;
+    ret = true;
+  }
+  else
+  {
+    // put task into waiting reader list
+    hdl->waiting_readers |= task_bit;
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+  return ret;
+}
+
+/**************************************************************************//**
+*
+* mss_rwlock_read_unlock
+*
+* @brief      release a read lock. When the last reader leaves, the waiting
+*             writer with the highest priority will be activated
+*
+* @param[in]  hdl        reader-writer lock handle
+*
+* @return     -
+*
+******************************************************************************/
+void mss_rwlock_read_unlock(mss_rwlock_t hdl)
+{
+  mss_int_flag_t int_flag;
+
+  // check handle
+  MSS_DEBUG_CHECK(hdl != MSS_RWLOCK_INVALID_HDL);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  // remove task from the reader list
+  hdl->reading_tasks &= ~mss_bitpos_to_bit[mss_running_task_id];
+
+  if(hdl->reading_tasks == 0)
+  {
+    // last reader has left, let a waiting writer in
+    rwlock_wake_writer(hdl);
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+/**************************************************************************//**
+*
+* mss_rwlock_write_lock
+*
+* @brief      lock a reader-writer lock for writing. When the lock is held by
+*             any other task, the task will be put into the waiting writer
+*             list.
+*
+* @param[in]  hdl        reader-writer lock handle
+*
+* @return     if true the write lock is held, if false the lock is not
+*             available
+*
+******************************************************************************/
+bool mss_rwlock_write_lock(mss_rwlock_t hdl)
+{
+  bool ret = false;
+  mss_task_bits_t task_bit;
+  mss_int_flag_t int_flag;
+
+  // check handle
+  MSS_DEBUG_CHECK(hdl != MSS_RWLOCK_INVALID_HDL);
+
+  // turn running task id into bit position
+  task_bit = mss_bitpos_to_bit[mss_running_task_id];
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  if(hdl->writing_task == mss_running_task_id)
+  {
+    // task already holds the write lock
+    ret = true;
+  }
+  else if((hdl->writing_task == MSS_INVALID_TASK_ID) &&
+          (hdl->reading_tasks == 0))
+  {
+    // lock is free, take it
+    hdl->writing_task = mss_running_task_id;
+    hdl->waiting_writers &= ~task_bit;
+    ret = true;
+  }
+  else
+  {
+    // put task into waiting writer list, this also blocks new readers
+    hdl->waiting_writers |= task_bit;
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+
+  return ret;
+}
+
+/**************************************************************************//**
+*
+* mss_rwlock_write_unlock
+*
+* @brief      release a write lock. The waiting writer with the highest
+*             priority will be activated, or all waiting readers if there is
+*             no waiting writer
+*
+* @param[in]  hdl        reader-writer lock handle
+*
+* @return     -
+*
+******************************************************************************/
+void mss_rwlock_write_unlock(mss_rwlock_t hdl)
+{
+  uint8_t task_id;
+  mss_int_flag_t int_flag;
+
+  // check handle
+  MSS_DEBUG_CHECK(hdl != MSS_RWLOCK_INVALID_HDL);
+
+  MSS_ENTER_CRITICAL_SECTION(int_flag);
+
+  // only the owner can release the write lock
+  if(hdl->writing_task == mss_running_task_id)
+  {
+    hdl->writing_task = MSS_INVALID_TASK_ID;
+
+    if(hdl->waiting_writers)
+    {
+      // writers are preferred
+      rwlock_wake_writer(hdl);
+    }
+    else
+    {
+      // activate all waiting readers
+      while(hdl->waiting_readers)
+      {
+        task_id = mss_get_highest_prio_task(hdl->waiting_readers);
+        mss_activate_task_int(task_id);
+        hdl->waiting_readers &= ~mss_bitpos_to_bit[task_id];
+      }
+    }
+  }
+
+  MSS_LEAVE_CRITICAL_SECTION(int_flag);
+}
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* rwlock_wake_writer
+*
+* @brief      activate the waiting writer with the highest priority. The task
+*             stays in the waiting writer list until it gets the lock, so
+*             new readers are kept out in the meantime
+*
+* @param[in]  hdl        reader-writer lock handle
+*
+* @return     -
+*
+******************************************************************************/
+static void rwlock_wake_writer(mss_rwlock_t hdl)
+{
+  if(hdl->waiting_writers)
+  {
+    mss_activate_task_int(mss_get_highest_prio_task(hdl->waiting_writers));
+  }
+}
+
+#endif /* (MSS_TASK_USE_RWLOCK == TRUE) */
@@ -59,12 +59,14 @@
 //*****************************************************************************
 
 /** mss_sema_t
- *  mss semaphore table data type
+ *  mss semaphore table data type. The units held per task take
+ *  2 * MSS_NUM_OF_TASKS bytes of RAM per semaphore.
  */
 struct mss_sema_tbl_t{
   uint16_t value;
   mss_task_bits_t waiting_tasks;
   mss_task_bits_t signaling_tasks;
+  uint16_t held[MSS_NUM_OF_TASKS];
 };
 
 // number of created semaphores
@@ -104,6 +106,7 @@ mss_sema_t mss_sema_create(uint16_t init_val)
 	sema_tbl[num_of_sema].value = init_val;
 	sema_tbl[num_of_sema].waiting_tasks = 0;
 	sema_tbl[num_of_sema].signaling_tasks = 0;
+	memset(sema_tbl[num_of_sema].held, 0, sizeof(sema_tbl[num_of_sema].held));
 
 	// return handle and increment number of mque block
 	ret_hdl = &sema_tbl[num_of_sema++];
@@ -117,8 +120,9 @@ mss_sema_t mss_sema_create(uint16_t init_val)
 * mss_sema_wait
 *
 * @brief      decrement (lock/down) a semaphore. A task can only lock a
-*             semaphore once. When semaphore is not available, the task
-*             will be put into waiting task list.
+*             semaphore once with this function (use @ref mss_sema_wait_n to
+*             hold more than one unit). When semaphore is not available, the
+*             task will be put into waiting task list.
 *
 * @param[in]  hdl        semaphore handle
 *
@@ -127,34 +131,70 @@ mss_sema_t mss_sema_create(uint16_t init_val)
 *
 ******************************************************************************/
 bool mss_sema_wait(mss_sema_t hdl)
+{
+  // check task id
+  MSS_DEBUG_CHECK(hdl != MSS_SEMA_INVALID_HDL);
+
+  // check if calling task hasn't locked the semaphore before
+  if(hdl->signaling_tasks & mss_bitpos_to_bit[mss_running_task_id])
+  {
+    return false;
+  }
+
+  return mss_sema_wait_n(hdl, 1);
+}
+
+/**************************************************************************//**
+*
+* mss_sema_wait_n
+*
+* @brief      decrement (lock/down) a semaphore by n units at once. A task may
+*             call this function several times, the number of units held by
+*             each task is tracked. When less than n units are available, no
+*             unit is taken and the task will be put into waiting task list.
+*
+* @param[in]  hdl        semaphore handle
+* @param[in]  n          number of units to be taken (at least 1)
+*
+* @return     if true semaphore is successfully decremented, if false semaphore
+*             is not available or n is 0
+*
+******************************************************************************/
+bool mss_sema_wait_n(mss_sema_t hdl, uint16_t n)
 {
   bool ret = false;
   uint16_t task_bit;
   mss_int_flag_t int_flag;
 
-  // check task id
+  // check parameters
   MSS_DEBUG_CHECK(hdl != MSS_SEMA_INVALID_HDL);
+  MSS_DEBUG_CHECK(n > 0);
+
+  // nothing to wait for, the task would never be woken up
+  if(n == 0)
+  {
+    return false;
+  }
 
   // turn running task id into bit position
   task_bit = mss_bitpos_to_bit[mss_running_task_id];
 
   MSS_ENTER_CRITICAL_SECTION(int_flag);
 
-  // check if semaphore is available
-  if(hdl->value > 0)
+  // check if semaphore has enough units available
+  if(hdl->value >= n)
   {
-	// check if calling task hasn't locked the semaphore before
-	if(!(hdl->signaling_tasks & task_bit))
-	{
-      // decrement semaphore value
-	  hdl->value--;
-
-      // set the corresponding task bit in the signaling task list
-	  hdl->signaling_tasks |= task_bit;
-
-	  // return TRUE as locking semaphore succeeds
-	  ret = true;
-	}
+    // decrement semaphore value
+    hdl->value -= n;
+
+    // account the units to the calling task
+    hdl->held[mss_running_task_id] += n;
+
+    // set the corresponding task bit in the signaling task list
+    hdl->signaling_tasks |= task_bit;
+
+    // return TRUE as locking semaphore succeeds
+    ret = true;
   }
   else
   {
@@ -171,9 +211,9 @@ bool mss_sema_wait(mss_sema_t hdl)
 *
 * mss_sema_post
 *
-* @brief      increment (unlock/up) a semaphore. The waiting task with the
-*             highest priority will be activated upon incrementing the
-*             semaphore value
+* @brief      increment (unlock/up) a semaphore. The waiting tasks will be
+*             activated upon incrementing the semaphore value, the one with
+*             the highest priority gets the unit
 *
 * @param[in]  hdl        semaphore handle
 *
@@ -182,7 +222,27 @@ bool mss_sema_wait(mss_sema_t hdl)
 ******************************************************************************/
 void mss_sema_post(mss_sema_t hdl)
 {
-  uint16_t task_bit;
+  mss_sema_post_n(hdl, 1);
+}
+
+/**************************************************************************//**
+*
+* mss_sema_post_n
+*
+* @brief      increment (unlock/up) a semaphore by n units. A task can only
+*             give back the units it holds, n is limited accordingly. All
+*             waiting tasks are activated and take their units again in
+*             priority order, so a task whose request fits gets its units
+*             even if a higher priority task waits for more than are free
+*
+* @param[in]  hdl        semaphore handle
+* @param[in]  n          number of units to be given back
+*
+* @return     -
+*
+******************************************************************************/
+void mss_sema_post_n(mss_sema_t hdl, uint16_t n)
+{
   uint8_t waiting_task_id;
   mss_int_flag_t int_flag;
 
@@ -191,30 +251,35 @@ void mss_sema_post(mss_sema_t hdl)
 
   MSS_ENTER_CRITICAL_SECTION(int_flag);
 
-  // turn running task id into bit position
-  task_bit = mss_bitpos_to_bit[mss_running_task_id];
-  
-  // check if task has locked the semaphore before
-  if(hdl->signaling_tasks & task_bit)
+  // limit to the number of units held by the task
+  if(n > hdl->held[mss_running_task_id])
   {
-    // increment the semaphore value
-    hdl->value++;
+    n = hdl->held[mss_running_task_id];
+  }
+
+  // increment the semaphore value
+  hdl->value += n;
+  hdl->held[mss_running_task_id] -= n;
 
+  if(hdl->held[mss_running_task_id] == 0)
+  {
     // remove task from the signaling list
-    hdl->signaling_tasks &= ~task_bit;
+    hdl->signaling_tasks &= ~mss_bitpos_to_bit[mss_running_task_id];
+  }
 
-    // check if there is waiting task(s)
-    if(hdl->waiting_tasks)
-    {
-      // search the task with highest priority in the waiting task list
-      waiting_task_id = mss_get_highest_prio_task(hdl->waiting_tasks);
+  // activate every waiting task if units were given back, the requests are
+  // not recorded: each task tries again and goes back into the waiting list
+  // if its request does not fit
+  while((n > 0) && (hdl->waiting_tasks))
+  {
+    // search the task with highest priority in the waiting task list
+    waiting_task_id = mss_get_highest_prio_task(hdl->waiting_tasks);
 
-      // activate the waiting task with highest priority
-      mss_activate_task_int(waiting_task_id);
+    // activate the waiting task
+    mss_activate_task_int(waiting_task_id);
 
-      // remove task from waiting task list
-      hdl->waiting_tasks &= ~mss_bitpos_to_bit[waiting_task_id];
-    }
+    // remove task from waiting task list
+    hdl->waiting_tasks &= ~mss_bitpos_to_bit[waiting_task_id];
   }
 
   MSS_LEAVE_CRITICAL_SECTION(int_flag);
@@ -96,6 +96,14 @@ typedef struct mss_sema_tbl_t*   mss_sema_t;
         do{while(mss_sema_wait(hdl) == FALSE) \
            MSS_RETURN(context);}while(0)
 
+/** MSS_SEMA_WAIT_N
+ *  macro function to wait for n units of a semaphore, and blocks if not
+ *  enough units are available
+ */
+#define MSS_SEMA_WAIT_N(hdl, n, context)            \
+        do{while(mss_sema_wait_n(hdl, n) == FALSE)  \
+           MSS_RETURN(context);}while(0)
+
 
 //*****************************************************************************
 // External function declarations
@@ -119,8 +127,9 @@ mss_sema_t mss_sema_create(uint16_t init_val);
 * mss_sema_wait
 *
 * @brief      decrement (lock/down) a semaphore. A task can only lock a
-*             semaphore once. When semaphore is not available, the task
-*             will be put into waiting task list.
+*             semaphore once with this function (use @ref mss_sema_wait_n to
+*             hold more than one unit). When semaphore is not available, the
+*             task will be put into waiting task list.
 *
 * @param[in]  hdl        semaphore handle
 *
@@ -130,13 +139,31 @@ mss_sema_t mss_sema_create(uint16_t init_val);
 ******************************************************************************/
 bool mss_sema_wait(mss_sema_t hdl);
 
+/**************************************************************************//**
+*
+* mss_sema_wait_n
+*
+* @brief      decrement (lock/down) a semaphore by n units at once. A task may
+*             call this function several times, the number of units held by
+*             each task is tracked. When less than n units are available, no
+*             unit is taken and the task will be put into waiting task list.
+*
+* @param[in]  hdl        semaphore handle
+* @param[in]  n          number of units to be taken (at least 1)
+*
+* @return     if true semaphore is successfully decremented, if false semaphore
+*             is not available or n is 0
+*
+******************************************************************************/
+bool mss_sema_wait_n(mss_sema_t hdl, uint16_t n);
+
 /**************************************************************************//**
 *
 * mss_sema_post
 *
-* @brief      increment (unlock/up) a semaphore. The waiting task with the
-*             highest priority will be activated upon incrementing the
-*             semaphore value
+* @brief      increment (unlock/up) a semaphore. The waiting tasks will be
+*             activated upon incrementing the semaphore value, the one with
+*             the highest priority gets the unit
 *
 * @param[in]  hdl        semaphore handle
 *
@@ -145,6 +172,24 @@ bool mss_sema_wait(mss_sema_t hdl);
 ******************************************************************************/
 void mss_sema_post(mss_sema_t hdl);
 
+/**************************************************************************//**
+*
+* mss_sema_post_n
+*
+* @brief      increment (unlock/up) a semaphore by n units. A task can only
+*             give back the units it holds, n is limited accordingly. All
+*             waiting tasks are activated and take their units again in
+*             priority order, so a task whose request fits gets its units
+*             even if a higher priority task waits for more than are free
+*
+* @param[in]  hdl        semaphore handle
+* @param[in]  n          number of units to be given back
+*
+* @return     -
+*
+******************************************************************************/
+void mss_sema_post_n(mss_sema_t hdl, uint16_t n);
+
 /** @} MSS Semaphore API Functions */
 
 /** @} MSS_Sema_API */
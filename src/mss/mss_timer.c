@@ -72,6 +72,13 @@ struct mss_timer_tbl_t {
   mss_timer_state_t state;
 };
 
+// index type of the timer blocks, wider only for large (host) configurations
+#if (MSS_MAX_NUM_OF_TIMER > 255)
+typedef uint16_t timer_idx_t;
+#else
+typedef uint8_t timer_idx_t;
+#endif
+
 // linked list of active timer
 static llist_t active_timer_llist;
 
@@ -79,7 +86,7 @@ static llist_t active_timer_llist;
 static struct mss_timer_tbl_t timer_tbl[MSS_MAX_NUM_OF_TIMER];
 
 // number of used mss timer blocks
-static uint8_t num_of_timer = 0;
+static timer_idx_t num_of_timer = 0;
 
 // MSB mask for knowing in which half the timer tick resides
 #define MSB_TMR_MASK  (mss_timer_tick_t) (1UL << ( (sizeof(mss_timer_tick_t)*8) - 1 ))
@@ -92,6 +99,16 @@ static uint8_t num_of_timer = 0;
 #define TIMER_ALL_RUNNING_MASK   (MSS_TIMER_STATE_RUNNING_ONE_SHOT | \
 		                          MSS_TIMER_STATE_RUNNING_PERIODIC)
 
+// a timer is in the active timer list while it runs, a periodic one also
+// while its expiration has not been read yet
+#define TIMER_IN_LIST(tmr)       (((tmr)->state & TIMER_ALL_RUNNING_MASK) || \
+                                  (((tmr)->state & TIMER_ALL_EXPIRED_MASK) && \
+                                   ((tmr)->reload_tick > 0)))
+
+// a timer has expired once the timer tick has reached its expired tick
+#define TIMER_EXPIRED(tmr, now)  (!((mss_timer_tick_t)((now) - \
+                                   (tmr)->expired_tick) & MSB_TMR_MASK))
+
 //*****************************************************************************
 // Internal function declarations
 //*****************************************************************************
@@ -117,7 +134,7 @@ static int8_t timer_cmp(void *a, void *b);
 ******************************************************************************/
 void mss_timer_init(void)
 {
-  uint8_t i;
+  timer_idx_t i;
   
   // initialize timer blocks
   for(i=0 ; i<MSS_MAX_NUM_OF_TIMER ; i++)
@@ -257,11 +274,14 @@ void mss_timer_stop(mss_timer_t hdl)
 
   MSS_ENTER_CRITICAL_SECTION(int_flag);
 
-  if(hdl->state & TIMER_ALL_RUNNING_MASK)
+  if(TIMER_IN_LIST(hdl))
   {
     // search for the timer and remove it
     llist_remove(active_timer_llist, hdl);
+  }
 
+  if(hdl->state != MSS_TIMER_STATE_IDLE)
+  {
     // set timer state as idle
     hdl->state = MSS_TIMER_STATE_IDLE;
   }
@@ -377,23 +397,16 @@ bool mss_timer_tick(void)
   // set flag to indicate timer tick is already running
   timer_tick_running = true;
 
-  // copy hardware timer count tick to local timer tick
-  timer_tick_cnt = mss_timer_tick_cnt;
-
   // loop in case hardware timer tick interrupt occurs between
   // long active timer list processing
   do
   {
-	// if local timer tick is different than hardware timer tick,
-	// it means that the hardware timer has fired while the timer tick
-	// function is still processing the active timer list. Therefore
-	// the timer tick function shall update the local timer and continue
-	// processing the active timer list
-	if(timer_tick_cnt != mss_timer_tick_cnt)
-	{
-      // increment timer tick
-      timer_tick_cnt++;
-	}
+	// copy hardware timer count tick to local timer tick. Every timer
+	// whose expired tick has been reached is served, however many ticks
+	// have passed since the last call (the HAL may call this function
+	// only at the next expiry, or late), so the cost is per expired
+	// timer and not per elapsed tick
+	timer_tick_cnt = mss_timer_tick_cnt;
 
 	do
 	{
@@ -404,15 +417,20 @@ bool mss_timer_tick(void)
       youngest_tmr = llist_touch_first(active_timer_llist);
 	  if(youngest_tmr != NULL)
 	  {
-		if(youngest_tmr->expired_tick == timer_tick_cnt)
+		if(TIMER_EXPIRED(youngest_tmr, timer_tick_cnt))
 		{
 		  // wake up task
 		  mss_activate_task_int(youngest_tmr->task_id);
 
           // change timer state by shifting left one bit the state variable
           // which will change from running to expired in both one-shot and
-          // periodic mode or from expired periodic to overflow
-          youngest_tmr->state <<= 1;
+          // periodic mode or from expired periodic to overflow. A periodic
+          // timer stays in overflow, however many periods a late tick
+          // serves, so that it stays recognized as being in the list
+          if(youngest_tmr->state < MSS_TIMER_STATE_OVERFLOW)
+          {
+            youngest_tmr->state <<= 1;
+          }
 
           // remove timer object from active timer list
           llist_get_first(active_timer_llist);
@@ -420,15 +438,12 @@ bool mss_timer_tick(void)
           // if a periodic timer, returns to the active timer list
           if(youngest_tmr->reload_tick > 0)
           {
-            // update timer tick first
-            youngest_tmr->expired_tick = timer_tick_cnt +
-                                         youngest_tmr->reload_tick;
+            // update timer tick first, one period after the last expiry
+            // so that a late tick does not shift the following ones
+            youngest_tmr->expired_tick += youngest_tmr->reload_tick;
 
-            // put the timer into the active timer linked list
-            llist_add_first(active_timer_llist, youngest_tmr);
-
-            // sort the active timer list
-            llist_sort(active_timer_llist, timer_cmp);
+            // sort the timer into the active timer linked list
+            llist_insert(active_timer_llist, youngest_tmr, timer_cmp);
           }
 
           // return true
@@ -478,7 +493,9 @@ mss_timer_tick_t mss_timer_get_next_tick(void)
   youngest_tmr = llist_touch_first(active_timer_llist);
   if(youngest_tmr != NULL)
   {
-    ret = youngest_tmr->expired_tick - mss_timer_tick_cnt;
+    // a timer which has expired but is not served yet is due right now
+    ret = TIMER_EXPIRED(youngest_tmr, mss_timer_tick_cnt) ? 0 :
+          youngest_tmr->expired_tick - mss_timer_tick_cnt;
   }
 
   MSS_LEAVE_CRITICAL_SECTION(int_flag);
@@ -520,22 +537,22 @@ static bool timer_start(mss_timer_t hdl, mss_timer_tick_t tick,
     // disable timer interrupt to enable re-setting the timer
     MSS_ENTER_CRITICAL_SECTION(int_flag);
 
+    if(TIMER_IN_LIST(hdl))
+    {
+      // take the timer out, it is sorted in again at its new position
+      llist_remove(active_timer_llist, hdl);
+    }
+
     // set timer to active state and set timer counter
     hdl->expired_tick = mss_timer_tick_cnt + tick;
     hdl->reload_tick = reload;
 
-    if(!(hdl->state & TIMER_ALL_RUNNING_MASK))
-    {
-      // put the timer into the active timer linked list
-      llist_add_first(active_timer_llist, hdl);
-    }
-
     // set new state
     hdl->state = (reload > 0) ? MSS_TIMER_STATE_RUNNING_PERIODIC :
   		                      MSS_TIMER_STATE_RUNNING_ONE_SHOT;
 
-    // sort the active timer list
-    llist_sort(active_timer_llist, timer_cmp);
+    // sort the timer into the active timer linked list
+    llist_insert(active_timer_llist, hdl, timer_cmp);
 
     // return true
     ret = true;
@@ -561,43 +578,22 @@ static bool timer_start(mss_timer_t hdl, mss_timer_tick_t tick,
 static int8_t timer_cmp(void *a, void *b)
 {
   struct mss_timer_tbl_t *tmr1, *tmr2;
-  int8_t ret = 0;
+  mss_timer_tick_t key1, key2;
 
   // cast pointers
   tmr1 = (struct mss_timer_tbl_t*) a;
   tmr2 = (struct mss_timer_tbl_t*) b;
 
-  if(((tmr1->expired_tick & MSB_TMR_MASK) && (tmr2->expired_tick & MSB_TMR_MASK)) ||
-     ((!(tmr1->expired_tick & MSB_TMR_MASK)) && (!(tmr2->expired_tick & MSB_TMR_MASK))))
-  {
-    // both ticks are in the same half side just do normal compare
-    if(tmr1->expired_tick > tmr2->expired_tick)
-    {
-      ret = 1;
-    }
-    else
-    {
-      ret = -1;
-    }
-  }
-  else
-  {
-	  // see if first timer is in the same half side with the timer tick
-	if(((tmr1->expired_tick & MSB_TMR_MASK) && (mss_timer_tick_cnt & MSB_TMR_MASK)) ||
-	   ((!(tmr1->expired_tick & MSB_TMR_MASK)) && (!(mss_timer_tick_cnt & MSB_TMR_MASK))))
-	{
-	  // first timer is less than second timer because it resides in the
-	  // same half as the timer tick (the second timer must reside in
-      // the other half and therefore bigger than first timer)
-	  ret = -1;
-	}
-	else
-	{
-	  ret = 1;
-	}
-  }
+  // distance from the timer tick, offset by half of the tick range: the
+  // timers which have expired but are not served yet (up to half of the
+  // range behind) come first, then the running ones (up to half of the
+  // range ahead) by their expiry, also across the wraparound
+  key1 = (mss_timer_tick_t)(tmr1->expired_tick - mss_timer_tick_cnt +
+                            MSB_TMR_MASK);
+  key2 = (mss_timer_tick_t)(tmr2->expired_tick - mss_timer_tick_cnt +
+                            MSB_TMR_MASK);
 
-  return ret;
+  return (key1 > key2) ? 1 : -1;
 }
 
 #endif /* (MSS_TASK_USE_TIMER == TRUE) */
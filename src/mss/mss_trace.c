@@ -0,0 +1,183 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_trace.c
+* 
+* @brief    mcu simple scheduler trace ring buffer module
+*
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_TRACE
+*           defined as TRUE
+* 
+******************************************************************************/
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+#include "mss.h"
+#include "mss_int.h"
+
+#if (MSS_TRACE == TRUE)
+
+//*****************************************************************************
+// Global variables 
+//*****************************************************************************
+
+//*****************************************************************************
+// Macros (defines), data types, static variables
+//*****************************************************************************
+
+#if ((MSS_TRACE_BUF_SIZE & (MSS_TRACE_BUF_SIZE - 1)) != 0)
+#error MSS_TRACE_BUF_SIZE shall be a power of two
+#endif
+
+// trace ring buffer
+static mss_trace_rec_t trace_buf[MSS_TRACE_BUF_SIZE];
+
+// number of records ever written (wraps around), the next record goes to
+// trace_buf[trace_head % MSS_TRACE_BUF_SIZE]
+static volatile uint16_t trace_head = 0;
+
+// set when the ring has been filled up once
+static bool trace_full = false;
+
+//*****************************************************************************
+// Internal function declarations
+//*****************************************************************************
+
+
+//*****************************************************************************
+// External functions
+//*****************************************************************************
+
+/**************************************************************************//**
+*
+* mss_trace_record
+*
+* @brief      write a record into the trace ring, overwriting the oldest
+*             record if the ring is full
+*
+* @param[in]  event      one of the MSS_TRACE_EV_xxx values
+* @param[in]  task_id    task id the event belongs to
+*
+* @return     -
+*
+* @remark     shall be called with disabled interrupt
+*
+******************************************************************************/
+void mss_trace_record(uint8_t event, uint8_t task_id)
+{
+  mss_trace_rec_t* rec;
+
+  rec = &trace_buf[trace_head & (MSS_TRACE_BUF_SIZE - 1)];
+  rec->event = event;
+  rec->task_id = task_id;
+  rec->timestamp = mss_hal_get_timestamp();
+
+  // publish the record
+  if(++trace_head == MSS_TRACE_BUF_SIZE)
+  {
+    trace_full = true;
+  }
+}
+
+/**************************************************************************//**
+*
+* mss_trace_get_pos
+*
+* @brief      get the read position of the oldest record still in the ring
+*
+* @param      -
+*
+* @return     read position to be given to @ref mss_trace_read
+*
+******************************************************************************/
+uint16_t mss_trace_get_pos(void)
+{
+  // the ring has not been filled up yet
+  if(!trace_full)
+  {
+    return 0;
+  }
+
+  return trace_head - MSS_TRACE_BUF_SIZE;
+}
+
+/**************************************************************************//**
+*
+* mss_trace_read
+*
+* @brief      read the next trace record. The ring is never locked, the
+*             scheduler keeps recording (and overwriting the oldest
+*             records) while the records are read. If the record at the
+*             read position has been overwritten, reading continues at the
+*             oldest record still in the ring.
+*
+* @param[in,out] pos     read position, advanced on success
+* @param[out]    rec     buffer for the record
+*
+* @return     true if a record has been read, false if there is no newer
+*             record
+*
+******************************************************************************/
+bool mss_trace_read(uint16_t* pos, mss_trace_rec_t* rec)
+{
+  // check parameters
+  MSS_DEBUG_CHECK(pos != NULL);
+  MSS_DEBUG_CHECK(rec != NULL);
+
+  while(*pos != trace_head)
+  {
+    if((uint16_t)(trace_head - *pos) <= MSS_TRACE_BUF_SIZE)
+    {
+      *rec = trace_buf[*pos & (MSS_TRACE_BUF_SIZE - 1)];
+
+      // the copy is only valid if the slot has not been reused meanwhile
+      if((uint16_t)(trace_head - *pos) <= MSS_TRACE_BUF_SIZE)
+      {
+        (*pos)++;
+        return true;
+      }
+    }
+
+    // lost records, continue with the oldest one
+    *pos = mss_trace_get_pos();
+  }
+
+  return false;
+}
+
+//*****************************************************************************
+// Internal functions
+//*****************************************************************************
+
+#endif /* (MSS_TRACE == TRUE) */
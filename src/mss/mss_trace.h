@@ -0,0 +1,160 @@
+/******************************************************************************
+* Copyright (c) 2012-2013, Leo Hendrawan
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    * Redistributions of source code must retain the above copyright
+*      notice, this list of conditions and the following disclaimer.
+*    * Redistributions in binary form must reproduce the above copyright
+*      notice, this list of conditions and the following disclaimer in the
+*      documentation and/or other materials provided with the distribution.
+*    * Neither the name of the MSS PROJECT nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE MSS PROJECT OR ITS
+* CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+/**************************************************************************//**
+* 
+* @file     mss_trace.h
+* 
+* @brief    mcu simple scheduler trace ring buffer module header file
+* 
+* @version  0.2.1
+*
+* @remark   this will be included in compilation only if MSS_TRACE
+*           defined as TRUE
+* 
+******************************************************************************/
+
+#ifndef _MSS_TRACE_H_
+#define _MSS_TRACE_H_
+
+/**
+ * @ingroup   MSS_API
+ * @defgroup  MSS_Trace_API  MSS Trace API
+ * @brief     MSS scheduler trace ring buffer API definitions, data types,
+ *            and functions (enabled only if (MSS_TRACE == TRUE))
+ * @{
+ */
+
+//*****************************************************************************
+// Include section
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Global variable declarations 
+//*****************************************************************************
+
+
+//*****************************************************************************
+// Macros (defines) and data types 
+//*****************************************************************************
+
+/**
+ * @name MSS Trace Records
+ * @{
+ */
+
+/** mss_trace_rec_t
+ *  4 byte trace record
+ */
+typedef struct
+{
+  uint8_t event;          /**< one of the MSS_TRACE_EV_xxx values */
+  uint8_t task_id;        /**< task id the event belongs to */
+  uint16_t timestamp;     /**< HAL timestamp (see @ref MSS_TIMESTAMP_US) */
+} mss_trace_rec_t;
+
+/** MSS_TRACE_EV_ACTIVATE
+ *  task has been put into ready state
+ */
+#define MSS_TRACE_EV_ACTIVATE          (0x01)
+
+/** MSS_TRACE_EV_REACTIVATE
+ *  running or preempted task has been activated again
+ */
+#define MSS_TRACE_EV_REACTIVATE        (0x02)
+
+/** MSS_TRACE_EV_START
+ *  scheduler calls the task function
+ */
+#define MSS_TRACE_EV_START             (0x03)
+
+/** MSS_TRACE_EV_YIELD
+ *  task function has returned to the scheduler
+ */
+#define MSS_TRACE_EV_YIELD             (0x04)
+
+/** MSS_TRACE_EV_PREEMPT
+ *  running task has been interrupted by the software interrupt to run a
+ *  higher priority task
+ */
+#define MSS_TRACE_EV_PREEMPT           (0x05)
+
+/** MSS_TRACE_EV_RESUME
+ *  preempted task continues after the software interrupt
+ */
+#define MSS_TRACE_EV_RESUME            (0x06)
+
+/** @} MSS Trace Records */
+
+//*****************************************************************************
+// External function declarations
+//*****************************************************************************
+
+/**
+ * @name MSS Trace API Functions
+ * @{
+ */
+
+/**************************************************************************//**
+*
+* mss_trace_get_pos
+*
+* @brief      get the read position of the oldest record still in the ring
+*
+* @param      -
+*
+* @return     read position to be given to @ref mss_trace_read
+*
+******************************************************************************/
+uint16_t mss_trace_get_pos(void);
+
+/**************************************************************************//**
+*
+* mss_trace_read
+*
+* @brief      read the next trace record. The ring is never locked, the
+*             scheduler keeps recording (and overwriting the oldest
+*             records) while the records are read. If the record at the
+*             read position has been overwritten, reading continues at the
+*             oldest record still in the ring.
+*
+* @param[in,out] pos     read position, advanced on success
+* @param[out]    rec     buffer for the record
+*
+* @return     true if a record has been read, false if there is no newer
+*             record
+*
+******************************************************************************/
+bool mss_trace_read(uint16_t* pos, mss_trace_rec_t* rec);
+
+/** @} MSS Trace API Functions */
+
+/** @} MSS_Trace_API */
+
+#endif /* _MSS_TRACE_H_*/
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Convert an audit log dump of the lock firmware into CSV.
+
+The firmware sends its audit log (src/Audit.c) with AuditExport() when it
+receives a frame with '&' and the administrator credentials, before the
+reply frame. Every dump is a burst:
+
+    'M' 'A'  { seq, tick, key id, event, ~event }*  FF FF FF FF FF FF FF FF
+
+with 16 bit little endian seq, tick and key id: the event ring and then the
+ring of denied commands, oldest record first. The key id of a denied record
+is the number of denied commands it stands for.
+Capture the raw serial bytes into a file (several dumps may be appended)
+and convert them:
+
+    audit2csv.py capture.bin -o audit.csv
+
+Records of several dumps and both rings are merged by sequence number. The tick is the
+16 bit MSS timer tick (ms since boot, wraps every 65.5 s); a boot record
+starts a new tick base.
+"""
+
+import argparse
+import csv
+import sys
+
+REC_SIZE = 8
+FRAME_START = b"MA"
+FRAME_END = b"\xff" * REC_SIZE
+
+EVENTS = {
+    "b": "boot",
+    "l": "lock",
+    "u": "unlock",
+    "m": "manual",
+    "!": "denied",
+    "e": "enroll",
+    "r": "revoke",
+}
+
+
+def parse_frames(data):
+    """Yield (seq, tick, key_id, event) tuples of all dumps in data."""
+    pos = 0
+    while True:
+        pos = data.find(FRAME_START, pos)
+        if pos < 0:
+            return
+        pos += len(FRAME_START)
+        while pos + REC_SIZE <= len(data):
+            rec = data[pos:pos + REC_SIZE]
+            pos += REC_SIZE
+            if rec == FRAME_END:
+                break
+            if rec[6] ^ rec[7] != 0xFF:
+                continue
+            yield (rec[0] | (rec[1] << 8), rec[2] | (rec[3] << 8),
+                   rec[4] | (rec[5] << 8), chr(rec[6]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="raw UART capture with audit dumps")
+    parser.add_argument("-o", "--output", help="output CSV file "
+                        "(default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+
+    # later dumps repeat the records of earlier ones
+    records = {}
+    for rec in parse_frames(data):
+        records[rec[0]] = rec
+
+    # sequence numbers are 16 bit, a log across the wrap starts high
+    wraps = records and max(records) - min(records) > 0x8000
+    order = sorted(records, key=lambda s: s + 0x10000
+                   if wraps and s < 0x8000 else s)
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["seq", "tick", "key_id", "event"])
+    for seq, tick, key_id, event in (records[s] for s in order):
+        writer.writerow([seq, tick, "0x%04X" % key_id,
+                         EVENTS.get(event, event)])
+    if args.output:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Provision the administrator key of a lock and build enrollments.
+
+Every lock has an administrator key of its own (src/Cred.h): 16 random
+bytes in information memory segment D (0x1000), written when the device is
+programmed. The key is not in the source tree; keep the key file safe, it
+is the only way to enroll and revoke keys of that lock.
+
+    cred_provision.py device firmware.txt -o lock-17.txt -k lock-17.key
+
+adds a fresh key to a copy of the TI-TXT firmware image, to be programmed
+as a whole (segment D is erased and written with the firmware), and writes
+the key as 32 hex digits (bytes in memory order) into the key file, the
+format of mss_fleet -k.
+
+    cred_provision.py enroll -k lock-17.key -n NONCE -i 0x0200 -K KEY
+
+prints the payload of an ENROLL command (src/includes.h) in hex: the id,
+the new key (32 hex digits) encrypted with the administrator key under the
+nonce (16 hex digits, the reply of a CHALLENGE command) and the
+administrator credentials, see src/Auth.h.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+INFO_D = 0x1000
+KEY_LEN = 16
+NONCE_LEN = 8
+TAG_LEN = 8
+ADMIN_ID = 0x0001
+ENROLL_CMD = b"e"
+M32 = 0xFFFFFFFF
+
+
+def rotl(x, b):
+    return ((x << b) | (x >> (32 - b))) & M32
+
+
+def permute(v):
+    """Chaskey-12 permutation, as PERMUTE of src/Auth.c."""
+    for _ in range(12):
+        v[0] = (v[0] + v[1]) & M32
+        v[1] = rotl(v[1], 5) ^ v[0]
+        v[0] = rotl(v[0], 16)
+        v[2] = (v[2] + v[3]) & M32
+        v[3] = rotl(v[3], 8) ^ v[2]
+        v[0] = (v[0] + v[3]) & M32
+        v[3] = rotl(v[3], 13) ^ v[0]
+        v[2] = (v[2] + v[1]) & M32
+        v[1] = rotl(v[1], 7) ^ v[2]
+        v[2] = rotl(v[2], 16)
+
+
+def times_two(k):
+    x = sum(w << (32 * i) for i, w in enumerate(k)) << 1
+    if x >> 128:
+        x = (x & ((1 << 128) - 1)) ^ 0x87
+    return [(x >> (32 * i)) & M32 for i in range(4)]
+
+
+def chaskey(key, msg):
+    """Full Chaskey-12 block of msg, as AuthChaskey of src/Auth.c."""
+    k = list(struct.unpack("<4I", key))
+    k1 = times_two(k)
+    k2 = times_two(k1)
+    v = list(k)
+    blocks = [msg[i:i + 16] for i in range(0, len(msg), 16)] or [b""]
+    for block in blocks[:-1]:
+        v = [a ^ b for a, b in zip(v, struct.unpack("<4I", block))]
+        permute(v)
+    last = blocks[-1]
+    if len(last) == 16:
+        sub = k1
+    else:
+        sub = k2
+        last = last + b"\x01" + b"\x00" * (15 - len(last))
+    v = [a ^ b ^ c for a, b, c in zip(v, struct.unpack("<4I", last), sub)]
+    permute(v)
+    return struct.pack("<4I", *[a ^ c for a, c in zip(v, sub)])
+
+
+def read_key(path):
+    with open(path) as f:
+        return parse_hex(f.read().strip(), KEY_LEN, "key file " + path)
+
+
+def parse_hex(text, length, what):
+    try:
+        data = bytes.fromhex(text)
+    except ValueError:
+        data = b""
+    if len(data) != length:
+        sys.exit("%s: %d hex digits expected" % (what, 2 * length))
+    return data
+
+
+def device(args):
+    with open(args.firmware) as f:
+        image = f.read()
+    if "@%04x" % INFO_D in image.lower():
+        sys.exit("%s: already has a segment D section" % args.firmware)
+    end = image.rstrip().rfind("q")
+    if end < 0:
+        sys.exit("%s: no TI-TXT end marker" % args.firmware)
+
+    key = os.urandom(KEY_LEN)
+    section = "@%04X\n%s\n" % (INFO_D, " ".join("%02X" % b for b in key))
+
+    # the key file first, a programmed key without it is lost
+    fd = os.open(args.key, os.O_WRONLY | os.O_CREAT | os.O_EXCL, 0o600)
+    with os.fdopen(fd, "w") as f:
+        f.write(key.hex() + "\n")
+    with open(args.output, "w") as f:
+        f.write(image[:end] + section + image[end:])
+
+
+def enroll(args):
+    admin_key = read_key(args.key)
+    nonce = parse_hex(args.nonce, NONCE_LEN, "nonce")
+    new_key = parse_hex(args.new_key, KEY_LEN, "new key")
+    key_id = int(args.id, 0)
+    if key_id in (0x0000, 0xFFFF, ADMIN_ID):
+        sys.exit("id 0x%04X can not be enrolled" % key_id)
+
+    # AuthCrypt: the full block of nonce | 0x00, then AuthMac over the
+    # nonce, opcode and arguments with the encrypted key
+    stream = chaskey(admin_key, nonce + b"\x00")
+    arg = struct.pack("<H", key_id) + bytes(
+        a ^ b for a, b in zip(new_key, stream))
+    tag = chaskey(admin_key, nonce + ENROLL_CMD + arg)[:TAG_LEN]
+    print((ENROLL_CMD + arg + struct.pack("<H", ADMIN_ID) + tag).hex())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("device", help="add a new administrator key to a "
+                       "firmware image")
+    p.add_argument("firmware", help="TI-TXT firmware image")
+    p.add_argument("-o", "--output", required=True,
+                   help="TI-TXT image to program")
+    p.add_argument("-k", "--key", required=True,
+                   help="key file to create (not overwritten)")
+    p.set_defaults(func=device)
+
+    p = sub.add_parser("enroll", help="payload of an ENROLL command")
+    p.add_argument("-k", "--key", required=True,
+                   help="key file of the lock")
+    p.add_argument("-n", "--nonce", required=True, help="nonce, hex")
+    p.add_argument("-i", "--id", required=True, help="key id to enroll")
+    p.add_argument("-K", "--new-key", required=True, help="new key, hex")
+    p.set_defaults(func=enroll)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""ISR-to-task latency benchmark under the mspdebug MSP430 simulator.
+
+Build the firmware with MSS_LATENCY_STATS set to TRUE, then run
+
+    latency_bench.py Debug/SentryMSP430.out Debug/SentryMSP430.map
+
+The script loads the image into the mspdebug "sim" driver and attaches
+simulated Timer0_A (MSS tick and timestamp counter, the only timer the
+firmware needs) and port 1/2 devices. It then toggles P1.7 and P2.4 to
+fire Port_1 and Port_2, runs the simulator in between, and finally reads
+the global mss_latency_stats[] table (its address comes from the linker
+map file). It prints min/avg/max and the histogram per interrupt source.
+
+The simulator has no USCI model, so the USCI0RX source shows up with zero
+samples here. Measure it on the target with the '%' UART dump instead.
+"""
+
+import argparse
+import re
+import struct
+import subprocess
+import sys
+
+# interrupt sources in the order of LAT_SRC_xxx in includes.h
+SOURCES = ["USCI0RX", "Port_1", "Port_2"]
+
+# simulated port stimuli: (source index, gpio device, base, irq, pin)
+STIMULI = [
+    (1, "port1", 0x0020, 2, 7),   # P1.7 key button, PORT1_VECTOR
+    (2, "port2", 0x0028, 3, 4),   # P2.4 manual override, PORT2_VECTOR
+]
+
+
+def find_symbol(map_file, name):
+    """Return the address of a global symbol in a CCS linker map file."""
+    pattern = re.compile(r"^\s*([0-9a-fA-F]{4,8})\s+_?%s\s*$" % re.escape(name))
+    with open(map_file) as f:
+        for line in f:
+            m = pattern.match(line)
+            if m:
+                return int(m.group(1), 16)
+    raise SystemExit("symbol %s not found in %s" % (name, map_file))
+
+
+def build_commands(args, table_addr, table_size):
+    cmds = [
+        "prog %s" % args.image,
+        "simio add timer ta0",
+        "simio config ta0 base 0x0160",
+        "simio config ta0 size 3",
+    ]
+    for _, dev, base, irq, pin in STIMULI:
+        cmds += [
+            "simio add gpio %s" % dev,
+            "simio config %s base 0x%04x" % (dev, base),
+            "simio config %s irq %d" % (dev, irq),
+            "simio config %s set %d 1" % (dev, pin),
+        ]
+
+    # let the firmware initialize
+    cmds.append("step %d" % args.boot_steps)
+
+    for i in range(args.events):
+        _, dev, _, _, pin = STIMULI[i % len(STIMULI)]
+        cmds += [
+            "simio config %s set %d 0" % (dev, pin),
+            "step %d" % args.steps,
+            "simio config %s set %d 1" % (dev, pin),
+            "step %d" % args.steps,
+        ]
+
+    cmds.append("md 0x%04x %d" % (table_addr, table_size))
+    return cmds
+
+
+def parse_md(output):
+    """Collect the bytes of mspdebug "md" output lines."""
+    data = bytearray()
+    for line in output.splitlines():
+        m = re.match(r"^\s*(?:0x)?[0-9a-fA-F]+:\s+((?:[0-9a-fA-F]{2}\s)+)",
+                     line)
+        if m:
+            data += bytes(int(b, 16) for b in m.group(1).split())
+    return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="firmware image (.out/.elf)")
+    parser.add_argument("map", help="linker map file of the image")
+    parser.add_argument("--mspdebug", default="mspdebug",
+                        help="mspdebug executable")
+    parser.add_argument("--events", type=int, default=50,
+                        help="number of port interrupts to fire")
+    parser.add_argument("--steps", type=int, default=20000,
+                        help="instructions to simulate after each edge")
+    parser.add_argument("--boot-steps", type=int, default=200000,
+                        help="instructions to simulate before the first edge")
+    parser.add_argument("--buckets", type=int, default=8,
+                        help="MSS_LATENCY_NUM_OF_BUCKETS")
+    parser.add_argument("--bucket-base", type=int, default=16,
+                        help="MSS_LATENCY_BUCKET_BASE")
+    parser.add_argument("--us-per-count", type=float, default=1.0,
+                        help="MSS_TIMESTAMP_US")
+    args = parser.parse_args()
+
+    # min, max, sum, cnt, hist[] (MSP430: little endian, 16 bit aligned)
+    entry_fmt = "<HHIH%dH" % args.buckets
+    entry_size = struct.calcsize(entry_fmt)
+    table_addr = find_symbol(args.map, "mss_latency_stats")
+
+    cmds = build_commands(args, table_addr, entry_size * len(SOURCES))
+    result = subprocess.run([args.mspdebug, "sim"] + cmds,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise SystemExit("mspdebug failed")
+
+    data = parse_md(result.stdout)
+    if len(data) < entry_size * len(SOURCES):
+        sys.stderr.write(result.stdout)
+        raise SystemExit("could not read mss_latency_stats")
+
+    bounds = ["<%d" % (args.bucket_base << i) for i in range(args.buckets - 1)]
+    bounds.append(">=%d" % (args.bucket_base << (args.buckets - 2)))
+
+    print("%-8s %6s %8s %8s %8s   histogram (counts) %s" %
+          ("source", "n", "min us", "avg us", "max us", " ".join(bounds)))
+    for i, name in enumerate(SOURCES):
+        entry = struct.unpack_from(entry_fmt, data, i * entry_size)
+        lat_min, lat_max, lat_sum, cnt = entry[:4]
+        hist = entry[4:]
+        if cnt == 0:
+            print("%-8s %6d %8s %8s %8s" % (name, 0, "-", "-", "-"))
+            continue
+        scale = args.us_per_count
+        print("%-8s %6d %8.1f %8.1f %8.1f   %s" %
+              (name, cnt, lat_min * scale, lat_sum * scale / cnt,
+               lat_max * scale, " ".join(str(h) for h in hist)))
+
+
+if __name__ == "__main__":
+    main()
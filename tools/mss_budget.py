@@ -0,0 +1,457 @@
+#!/usr/bin/env python3
+"""Code size, RAM and worst-case stack budget check of the firmware.
+
+Run after every link (src/makefile.targets hooks it into the CCS build):
+
+    mss_budget.py Debug/UART.map Debug/UART.out --budget budget.txt
+
+Sizes: the TI linker map file gives the .text/.const (flash), .data and
+.bss (RAM) bytes of every object file and library, which are reported and
+compared to the per-module budgets.
+
+Stack: the code of the image (ELF) is scanned for the stack operations of
+every function (PUSH, SUB #n,SP, CALL) and its calls, direct ones from the
+code and indirect ones (task functions called by mss_scheduler) from the
+"icall" lines of the budget file. The deepest path from the reset vector
+is the main stack. Every interrupt service routine from the vector table
+adds its own depth plus 4 bytes (PC, SR). An ISR which enables interrupts
+again (EINT, e.g. WDT_ISR and SwInt_ISR through __enable_interrupt()) can
+be interrupted by any other ISR, so the estimate is
+
+    main + all nesting ISRs + the deepest other ISR
+
+assuming an ISR does not interrupt itself. Pushes and stack adjustments
+are summed over a whole function, so the estimate is an upper bound.
+
+The script fails (exit 1) if a module, the flash or RAM total or the stack
+estimate is over its budget, or if the stack estimate does not fit the
+.stack section. --update rewrites the budgets with the current values.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+# stack bytes pushed by the CPU on interrupt entry (PC, SR)
+ISR_FRAME = 4
+
+# stack bytes of a CALL (return address)
+CALL_FRAME = 2
+
+FLASH_SECTIONS = (".text", ".const", ".cinit")
+RAM_SECTIONS = (".data", ".bss", ".sysmem")
+
+
+# ---------------------------------------------------------------------------
+# Map file
+# ---------------------------------------------------------------------------
+
+def parse_map(map_file):
+    """Return (module sizes, memory usage, section sizes) of a TI map file.
+
+    module sizes: {module: {"text": n, "data": n, "bss": n}}, library
+    members are accounted to the library.
+    """
+    modules = {}
+    memory = {}
+    sections = {}
+    section = None
+    library = None
+
+    out_re = re.compile(r"^(\S+)\s+\d+\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})")
+    in_re = re.compile(r"^\s+[0-9a-fA-F]{8}\s+([0-9a-fA-F]{8})\s+(.*)$")
+    mem_re = re.compile(r"^\s+(\w+)\s+[0-9a-fA-F]{8}\s+([0-9a-fA-F]{8})\s+"
+                        r"([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})")
+
+    with open(map_file) as f:
+        lines = f.read().splitlines()
+
+    for i, line in enumerate(lines):
+        m = mem_re.match(line)
+        if m and section is None:
+            memory[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+            continue
+
+        # output section, its name may stand on a line of its own
+        m = out_re.match(line)
+        if m is None and re.match(r"^\S+\s*$", line) and i + 1 < len(lines):
+            m = re.match(r"^\*?\s+\d+\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})",
+                         lines[i + 1])
+            if m:
+                section = line.strip()
+                sections[section] = int(m.group(2), 16)
+                library = None
+                continue
+        if m:
+            section = m.group(1)
+            sections[section] = int(m.group(3), 16)
+            library = None
+            continue
+
+        m = in_re.match(line)
+        if m is None or section is None:
+            continue
+        size = int(m.group(1), 16)
+        source = m.group(2).strip()
+        if source.startswith("--HOLE--") or source.startswith("("):
+            continue
+
+        # "lib : member (.text:x)", ": member (...)" continues the library
+        lib = re.match(r"^(\S*)\s*:\s+\S+", source)
+        if lib:
+            library = lib.group(1) or library
+            module = library
+        else:
+            module = source.split()[0]
+
+        if section in FLASH_SECTIONS:
+            kind = "text"
+        elif section in (".data",):
+            kind = "data"
+        elif section in (".bss", ".sysmem"):
+            kind = "bss"
+        else:
+            continue
+        sizes = modules.setdefault(module, {"text": 0, "data": 0, "bss": 0})
+        sizes[kind] += size
+
+    return modules, memory, sections
+
+
+# ---------------------------------------------------------------------------
+# ELF image
+# ---------------------------------------------------------------------------
+
+class Image:
+    """Code, function symbols and interrupt vectors of an MSP430 ELF file."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.elf = f.read()
+        if self.elf[:4] != b"\x7fELF" or self.elf[4] != 1:
+            raise SystemExit("%s is not an ELF32 image" % path)
+
+        shoff, = struct.unpack_from("<I", self.elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.elf,
+                                                        0x2E)
+        self.sections = [struct.unpack_from("<IIIIIIIIII", self.elf,
+                                            shoff + i * shentsize)
+                         for i in range(shnum)]
+        names_off = self.sections[shstrndx][4]
+        self.section_names = [self._str(names_off, s[0])
+                              for s in self.sections]
+
+        self.functions = {}
+        for sec in self.sections:
+            if sec[1] != 2:                 # SHT_SYMTAB
+                continue
+            strtab = self.sections[sec[6]][4]
+            for pos in range(sec[4], sec[4] + sec[5], 16):
+                name_off, value, _, info, _, _ = struct.unpack_from(
+                    "<IIIBBH", self.elf, pos)
+                name = self._str(strtab, name_off)
+                # functions, not the compiler's local labels ($C$L1, ...)
+                if (info & 0xF) == 2 and not name.startswith("$"):
+                    self.functions.setdefault(value, name)
+
+        self.starts = sorted(self.functions)
+
+    def _str(self, table, offset):
+        end = self.elf.index(b"\0", table + offset)
+        return self.elf[table + offset:end].decode()
+
+    def read(self, addr, size):
+        """Bytes at a load address, None if not in a PROGBITS section."""
+        for sec in self.sections:
+            if sec[1] == 1 and sec[3] <= addr and addr + size <= sec[3] + sec[5]:
+                off = sec[4] + addr - sec[3]
+                return self.elf[off:off + size]
+        return None
+
+    def vectors(self):
+        """Return {vector section name: handler address}."""
+        vec = {}
+        for name, sec in zip(self.section_names, self.sections):
+            if sec[1] == 1 and sec[5] == 2 and sec[3] >= 0xFFE0:
+                vec[name], = struct.unpack("<H", self.read(sec[3], 2))
+        return vec
+
+    def function_end(self, addr):
+        """Start of the next function (end of the one at addr)."""
+        later = [a for a in self.starts if a > addr]
+        return later[0] if later else addr
+
+
+# ---------------------------------------------------------------------------
+# Stack analysis
+# ---------------------------------------------------------------------------
+
+def src_ext_words(As, reg):
+    """Extension words of a source operand."""
+    if As == 1:
+        return 0 if reg == 3 else 1
+    if As == 3:
+        return 1 if reg == 0 else 0
+    return 0
+
+
+# constant generator values of SUB/ADD src operands (reg, As)
+CONSTANTS = {(3, 0): 0, (3, 1): 1, (3, 2): 2, (3, 3): 0xFFFF,
+             (2, 2): 4, (2, 3): 8}
+
+
+def scan_function(image, addr):
+    """Return (stack bytes, direct callees, indirect calls, enables GIE)."""
+    code = image.read(addr, image.function_end(addr) - addr) or b""
+    words = struct.unpack("<%dH" % (len(code) // 2), code[:len(code) & ~1])
+    stack = 0
+    callees = set()
+    indirect = 0
+    eint = False
+
+    i = 0
+    while i < len(words):
+        w = words[i]
+        ext = words[i + 1] if i + 1 < len(words) else 0
+
+        if 0x2000 <= w < 0x4000:            # jumps
+            i += 1
+            continue
+
+        if 0x1000 <= w < 0x1400:            # single operand
+            op, As, reg = (w >> 7) & 7, (w >> 4) & 3, w & 15
+            if op == 4:                     # PUSH
+                stack += 2
+            elif op == 5:                   # CALL
+                if As == 3 and reg == 0:
+                    callees.add(ext)
+                else:
+                    indirect += 1
+            i += 1 + src_ext_words(As, reg)
+            continue
+
+        if w >= 0x4000:                     # double operand
+            op, src = w >> 12, (w >> 8) & 15
+            Ad, As, dst = (w >> 7) & 1, (w >> 4) & 3, w & 15
+            n = src_ext_words(As, src)
+            imm = ext if (src == 0 and As == 3) else CONSTANTS.get((src, As))
+
+            if dst == 1 and Ad == 0 and imm is not None:
+                if op == 8:                 # SUB #n, SP
+                    stack += imm if imm < 0x8000 else 0
+                elif op == 5 and imm >= 0x8000:   # ADD #-n, SP
+                    stack += 0x10000 - imm
+            elif op == 4 and dst == 0 and Ad == 0 and src == 0 and As == 3:
+                callees.add(ext)            # BR #f (tail call)
+            elif op == 0xD and dst == 2 and Ad == 0 and imm is not None:
+                eint |= bool(imm & 0x08)    # BIS #GIE, SR
+            i += 1 + n + Ad
+            continue
+
+        i += 1
+
+    # branches into the function itself are no calls, the epilog helpers
+    # only pop
+    callees = {c for c in callees
+               if c in image.functions and c != addr and
+               not image.functions[c].startswith("__mspabi_func_epilog")}
+    return stack, callees, indirect, eint
+
+
+def stack_depths(image, icalls):
+    """Return ({function: worst-case depth}, {function: nesting}, warnings)."""
+    info = {addr: scan_function(image, addr) for addr in image.functions}
+    by_name = {name: addr for addr, name in image.functions.items()}
+    depth = {}
+    warnings = []
+
+    def visit(addr, path):
+        if addr in depth:
+            return depth[addr]
+        name = image.functions[addr]
+        if addr in path:
+            warnings.append("recursion through %s, not counted" % name)
+            return 0
+        stack, callees, indirect, _ = info[addr]
+        targets = set(callees)
+        if indirect:
+            if name in icalls:
+                for callee in icalls[name]:
+                    if callee in by_name:
+                        targets.add(by_name[callee])
+                    else:
+                        warnings.append("icall target %s not in image" %
+                                        callee)
+            else:
+                warnings.append("%d indirect call(s) in %s without an icall "
+                                "line, not counted" % (indirect, name))
+        deepest = max([visit(t, path | {addr}) for t in targets] or [0])
+        depth[addr] = stack + (CALL_FRAME + deepest if targets else 0)
+        return depth[addr]
+
+    for addr in image.functions:
+        visit(addr, frozenset())
+
+    named = {image.functions[a]: d for a, d in depth.items()}
+    nesting = {image.functions[a]: info[a][3] for a in image.functions}
+    return named, nesting, warnings
+
+
+def worst_case_stack(image, icalls):
+    """Return (total, main depth, [(isr, depth, nesting)], warnings)."""
+    depth, nesting, warnings = stack_depths(image, icalls)
+    vectors = image.vectors()
+
+    reset = vectors.pop(".reset", None)
+    main = depth.get(image.functions.get(reset), 0)
+
+    isrs = []
+    for vec, addr in sorted(vectors.items()):
+        name = image.functions.get(addr)
+        if name is None:
+            warnings.append("vector %s does not point to a function" % vec)
+            continue
+        isrs.append((name, ISR_FRAME + depth[name], nesting[name]))
+
+    total = main + sum(d for _, d, nest in isrs if nest)
+    others = [d for _, d, nest in isrs if not nest]
+    total += max(others or [0])
+    return total, main, isrs, warnings
+
+
+# ---------------------------------------------------------------------------
+# Budget file
+# ---------------------------------------------------------------------------
+
+def read_budget(path):
+    """Parse the budget file.
+
+    module <name> <text> <data> <bss>
+    flash <bytes> / ram <bytes> / stack <bytes>
+    icall <caller> <callee> [<callee> ...]
+    """
+    budget = {"module": {}, "icall": {}}
+    with open(path) as f:
+        for num, line in enumerate(f, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            key = fields[0]
+            try:
+                if key == "module" and len(fields) == 5:
+                    budget["module"][fields[1]] = {
+                        "text": int(fields[2], 0), "data": int(fields[3], 0),
+                        "bss": int(fields[4], 0)}
+                elif key in ("flash", "ram", "stack") and len(fields) == 2:
+                    budget[key] = int(fields[1], 0)
+                elif key == "icall" and len(fields) >= 3:
+                    budget["icall"].setdefault(fields[1], []).extend(
+                        fields[2:])
+                else:
+                    raise ValueError
+            except ValueError:
+                raise SystemExit("%s:%d: invalid line" % (path, num))
+    return budget
+
+
+def write_budget(path, budget, modules, flash, ram, stack):
+    """Rewrite the budget file with the current values."""
+    with open(path) as f:
+        header = [l for l in f.read().splitlines() if l.startswith("#")]
+    lines = header + [""]
+    lines.append("flash   %d" % flash)
+    lines.append("ram     %d" % ram)
+    lines.append("stack   %d" % stack)
+    lines.append("")
+    for name in sorted(modules):
+        s = modules[name]
+        lines.append("module  %-24s %5d %5d %5d" %
+                     (name, s["text"], s["data"], s["bss"]))
+    lines.append("")
+    for caller in sorted(budget["icall"]):
+        lines.append("icall   %s %s" %
+                     (caller, " ".join(budget["icall"][caller])))
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+# ---------------------------------------------------------------------------
+# Main
+# ---------------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("image", help="linked image (.out ELF)")
+    parser.add_argument("--budget", required=True, help="budget file")
+    parser.add_argument("--update", action="store_true",
+                        help="write the current values as the new budgets")
+    args = parser.parse_args()
+
+    budget = read_budget(args.budget)
+    modules, memory, sections = parse_map(args.map)
+    image = Image(args.image)
+
+    flash = memory.get("FLASH", (0, 0))
+    ram = memory.get("RAM", (0, 0))
+    stack_size = sections.get(".stack", 0)
+    ram_static = ram[1] - stack_size
+
+    stack, main_depth, isrs, warnings = worst_case_stack(image,
+                                                         budget["icall"])
+
+    errors = []
+
+    print("%-26s %6s %6s %6s" % ("module", "text", "data", "bss"))
+    for name in sorted(modules, key=lambda n: -modules[n]["text"]):
+        s = modules[name]
+        limit = budget["module"].get(name)
+        mark = "" if limit is not None else "  (no budget)"
+        for kind in ("text", "data", "bss"):
+            if limit is not None and s[kind] > limit[kind]:
+                errors.append("%s %s %d > budget %d" %
+                              (name, kind, s[kind], limit[kind]))
+                mark = "  over budget"
+        print("%-26s %6d %6d %6d%s" %
+              (name, s["text"], s["data"], s["bss"], mark))
+
+    print()
+    print("flash used         %6d of %6d bytes" % (flash[1], flash[0]))
+    print("RAM static         %6d of %6d bytes (.stack %d)" %
+          (ram_static, ram[0], stack_size))
+    print()
+    print("stack main         %6d bytes" % main_depth)
+    for name, depth, nest in isrs:
+        print("stack %-12s %6d bytes%s" %
+              (name, depth, " (enables interrupts)" if nest else ""))
+    print("stack estimate     %6d bytes (main + nesting ISRs + deepest other "
+          "ISR)" % stack)
+    for warning in warnings:
+        print("warning: %s" % warning)
+
+    if "flash" in budget and flash[1] > budget["flash"]:
+        errors.append("flash %d > budget %d" % (flash[1], budget["flash"]))
+    if "ram" in budget and ram_static > budget["ram"]:
+        errors.append("RAM %d > budget %d" % (ram_static, budget["ram"]))
+    if "stack" in budget and stack > budget["stack"]:
+        errors.append("stack estimate %d > budget %d" %
+                      (stack, budget["stack"]))
+    if stack > stack_size:
+        errors.append("stack estimate %d > .stack size %d (--stack_size)" %
+                      (stack, stack_size))
+
+    if args.update:
+        write_budget(args.budget, budget, modules, flash[1], ram_static,
+                     stack)
+        print("budgets updated in %s" % args.budget)
+        return
+
+    for error in errors:
+        sys.stderr.write("budget: %s\n" % error)
+    if errors:
+        raise SystemExit(1)
+
+
+if __name__ == "__main__":
+    main()
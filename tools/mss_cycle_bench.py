@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""MSS primitive and authentication cycle benchmark under mspdebug.
+
+Build the benchmark firmware (src/bench, "make -C src/bench"), then run
+
+    mss_cycle_bench.py src/bench/build/mss_cycle_bench.elf -o bench.csv
+
+The script loads the image into the mspdebug "sim" driver with a simulated
+Timer0_A (the cycle counter of the firmware), runs it to the breakpoint
+mss_bench_done and reads the global mss_bench_result (the addresses come
+from the ELF symbol table of the image). It writes one CSV line per
+operation and number of live objects: op,n,cycles. For AuthMac n is the
+message length in bytes, AuthCheck (the MAC and tag check of a lock
+command) does not depend on n.
+
+With --baseline the cycle counts are compared to an earlier CSV file and
+the script fails if an operation got slower by more than --tolerance, so
+regressions in the O(n) paths (timer list, message queue, memory blocks)
+are caught before they reach the target.
+"""
+
+import argparse
+import csv
+import re
+import struct
+import subprocess
+import sys
+
+# operations in the order of BENCH_OP_xxx in mss_cycle_bench.c
+OPS = [
+    "mss_activate_task",
+    "mss_timer_start",
+    "mss_timer_stop",
+    "mss_sema_wait",
+    "mss_sema_post",
+    "mss_mque_send",
+    "mss_mque_read",
+    "mss_mem_alloc",
+    "mss_mem_free",
+    "AuthMac",
+    "AuthCheck",
+]
+
+# bytes read from mss_bench_result, more than its size
+RESULT_READ_SIZE = 256
+
+
+def find_symbols(image, names):
+    """Return the addresses of global symbols from an ELF symbol table."""
+    with open(image, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        raise SystemExit("%s is not an ELF image" % image)
+
+    is64 = elf[4] == 2
+    endian = "<" if elf[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(endian + "Q", elf, 0x28)
+        shentsize, shnum = struct.unpack_from(endian + "HH", elf, 0x3A)
+        sh_fmt, sym_fmt = endian + "IIQQQQIIQQ", endian + "IBBHQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", elf, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + "HH", elf, 0x2E)
+        sh_fmt, sym_fmt = endian + "IIIIIIIIII", endian + "IIIBBH"
+    sym_size = struct.calcsize(sym_fmt)
+
+    sections = [struct.unpack_from(sh_fmt, elf, shoff + i * shentsize)
+                for i in range(shnum)]
+    found = {}
+    for sec in sections:
+        if sec[1] != 2:                     # SHT_SYMTAB
+            continue
+        offset, size, link = sec[4], sec[5], sec[6]
+        strtab = sections[link][4]
+        for pos in range(offset, offset + size, sym_size):
+            sym = struct.unpack_from(sym_fmt, elf, pos)
+            value = sym[4] if is64 else sym[1]
+            end = elf.index(b"\0", strtab + sym[0])
+            name = elf[strtab + sym[0]:end].decode().lstrip("_")
+            if name in names:
+                found[name] = value
+
+    for name in names:
+        if name not in found:
+            raise SystemExit("symbol %s not found in %s" % (name, image))
+    return found
+
+
+def parse_md(output):
+    """Collect the bytes of mspdebug "md" output lines."""
+    data = bytearray()
+    for line in output.splitlines():
+        m = re.match(r"^\s*(?:0x)?[0-9a-fA-F]+:\s+((?:[0-9a-fA-F]{2}\s)+)",
+                     line)
+        if m:
+            data += bytes(int(b, 16) for b in m.group(1).split())
+    return bytes(data)
+
+
+def run_bench(args):
+    syms = find_symbols(args.image, ["mss_bench_done", "mss_bench_result"])
+    cmds = [
+        "prog %s" % args.image,
+        "simio add timer ta0",
+        "simio config ta0 base 0x0160",
+        "simio config ta0 size 3",
+        "setbreak 0x%04x" % syms["mss_bench_done"],
+        "run",
+        "md 0x%04x %d" % (syms["mss_bench_result"], RESULT_READ_SIZE),
+    ]
+    result = subprocess.run([args.mspdebug, "sim"] + cmds,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise SystemExit("mspdebug failed")
+
+    # num_of_ops, num_of_n, n[], cycles[][] (MSP430: little endian)
+    data = parse_md(result.stdout)
+    num_of_ops, num_of_n = struct.unpack_from("<HH", data, 0)
+    if (num_of_ops != len(OPS) or
+            len(data) < 4 + 2 * num_of_n * (1 + num_of_ops)):
+        sys.stderr.write(result.stdout)
+        raise SystemExit("could not read mss_bench_result")
+
+    n = struct.unpack_from("<%dH" % num_of_n, data, 4)
+    cycles = struct.unpack_from("<%dH" % (num_of_ops * num_of_n), data,
+                                4 + 2 * num_of_n)
+    rows = []
+    for i, op in enumerate(OPS):
+        for j in range(num_of_n):
+            rows.append((op, n[j], cycles[i * num_of_n + j]))
+    return rows
+
+
+def check_baseline(rows, baseline, tolerance, slack):
+    """Return the rows slower than the baseline by more than tolerance."""
+    base = {}
+    with open(baseline) as f:
+        for row in csv.DictReader(f):
+            base[(row["op"], int(row["n"]))] = int(row["cycles"])
+
+    worse = []
+    for op, n, cycles in rows:
+        ref = base.get((op, n))
+        if ref is not None and cycles > ref * (1.0 + tolerance) + slack:
+            worse.append((op, n, ref, cycles))
+    return worse
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="benchmark firmware image (.elf/.out)")
+    parser.add_argument("--mspdebug", default="mspdebug",
+                        help="mspdebug executable")
+    parser.add_argument("-o", "--output", help="CSV file (default: stdout)")
+    parser.add_argument("--baseline", help="CSV file of an earlier run")
+    parser.add_argument("--tolerance", type=float, default=0.05,
+                        help="allowed relative increase over the baseline")
+    parser.add_argument("--slack", type=int, default=4,
+                        help="allowed absolute increase in cycles")
+    args = parser.parse_args()
+
+    rows = run_bench(args)
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out, lineterminator="\n")
+    writer.writerow(["op", "n", "cycles"])
+    writer.writerows(rows)
+    if args.output:
+        out.close()
+
+    if args.baseline:
+        worse = check_baseline(rows, args.baseline, args.tolerance,
+                               args.slack)
+        for op, n, ref, cycles in worse:
+            sys.stderr.write("regression: %s n=%d %d -> %d cycles\n" %
+                             (op, n, ref, cycles))
+        if worse:
+            raise SystemExit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Convert an MSS scheduler trace dump into Chrome/Perfetto trace JSON.
+
+The firmware sends the trace ring (MSS_TRACE == TRUE) with UARTPutTrace()
+when it receives '$'. Every dump is a binary frame:
+
+    'M' 'T'  { event, task_id, timestamp LSB, timestamp MSB }*  FF FF FF FF
+
+Capture the raw serial bytes into a file (several dumps may be appended)
+and convert them:
+
+    mss_trace2json.py capture.bin -o trace.json
+
+then open trace.json in chrome://tracing or https://ui.perfetto.dev.
+
+Timestamps are 16 bit HAL counts and are unwrapped on the assumption that
+consecutive records are less than one counter period apart (65.5 ms at
+the default 1 us per count).
+"""
+
+import argparse
+import json
+import sys
+
+EV_ACTIVATE = 0x01
+EV_REACTIVATE = 0x02
+EV_START = 0x03
+EV_YIELD = 0x04
+EV_PREEMPT = 0x05
+EV_RESUME = 0x06
+
+INVALID_TASK_ID = 0xFF
+FRAME_START = b"MT"
+FRAME_END = b"\xff\xff\xff\xff"
+
+
+def parse_frames(data):
+    """Yield (event, task_id, timestamp) tuples of all frames in data."""
+    pos = 0
+    while True:
+        pos = data.find(FRAME_START, pos)
+        if pos < 0:
+            return
+        pos += len(FRAME_START)
+        while pos + 4 <= len(data):
+            rec = data[pos:pos + 4]
+            pos += 4
+            if rec == FRAME_END:
+                break
+            yield rec[0], rec[1], rec[2] | (rec[3] << 8)
+
+
+def convert(records, us_per_count):
+    events = []
+    tasks = set()
+    last_raw = None
+    time = 0
+
+    def add(ph, task_id, name, **extra):
+        tasks.add(task_id)
+        ev = {"ph": ph, "pid": 0, "tid": task_id, "name": name,
+              "ts": time * us_per_count}
+        ev.update(extra)
+        events.append(ev)
+
+    for event, task_id, raw in records:
+        if last_raw is not None:
+            time += (raw - last_raw) & 0xFFFF
+        last_raw = raw
+
+        if event == EV_START:
+            add("B", task_id, "task %d" % task_id)
+        elif event == EV_YIELD:
+            add("E", task_id, "task %d" % task_id)
+        elif event in (EV_ACTIVATE, EV_REACTIVATE):
+            name = "activate" if event == EV_ACTIVATE else "reactivate"
+            add("i", task_id, name, s="t")
+        elif event == EV_PREEMPT and task_id != INVALID_TASK_ID:
+            add("E", task_id, "task %d" % task_id)
+            add("i", task_id, "preempted", s="t")
+        elif event == EV_RESUME and task_id != INVALID_TASK_ID:
+            add("B", task_id, "task %d" % task_id)
+
+    for task_id in sorted(tasks):
+        events.append({"ph": "M", "pid": 0, "tid": task_id,
+                       "name": "thread_name",
+                       "args": {"name": "MSS task %d" % task_id}})
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="raw UART capture with trace frames")
+    parser.add_argument("-o", "--output", help="output JSON file "
+                        "(default: stdout)")
+    parser.add_argument("--us-per-count", type=float, default=1.0,
+                        help="microseconds per timestamp count "
+                        "(MSS_TIMESTAMP_US, default 1)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+
+    trace = convert(parse_frames(data), args.us_per_count)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f, indent=1)
+    else:
+        json.dump(trace, sys.stdout, indent=1)
+        sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()